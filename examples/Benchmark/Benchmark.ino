@@ -0,0 +1,220 @@
+/*
+ * Benchmark.ino
+ *
+ * Repeatable on-device benchmark: runs fixed UI scenarios one after another and
+ * prints one machine-parseable line per scenario, so firmware releases can be
+ * compared on real hardware (diff or spreadsheet the BENCH lines).
+ *
+ * Scenarios (same values and timing on every run, no random()):
+ *   idle           - no input, baseline
+ *   hr_4hz         - homewind_set_hr_value() every 250 ms
+ *   cadence_storm  - homewind_set_csc_cadence() every 5 ms
+ *   fan_toggle     - all 4 fans toggled (animated) every 200 ms
+ *   modal          - settings overlay opened / closed every 700 ms
+ *   rotation       - display rotated 0 -> 90 -> 180 -> 270 every second
+ *   powersave      - SOFT_POWERSAVE entry / wake, PANEL_OFF entry / wake (as new sensor data does)
+ *
+ * Output (printf, same UART as the library):
+ *   BENCH_BEGIN version=1.5.9 scenarios=7
+ *   BENCH scenario=hr_4hz window_ms=... frames=... fps=... render_avg_us=... render_p99_us=...
+ *         render_max_us=... flushes=... flush_bytes=... flush_avg_us=... cpu_pct=... handler_max_us=...
+ *         touch_polls=... i2c_errors=... heap_delta=... heap_min_free=... largest_delta=... dma_delta=... psram_delta=...
+ *   BENCH_END
+ * (one line per scenario; wrapped here for reading). Counters come from
+ * homewind_get_perf_stats() (HOMEWIND_PERF_STATS 1 in lcd_config.h), heap
+ * deltas from homewind_get_mem_stats() before and after the scenario.
+ *
+ * The sketch shows the main screen and unlocks powersave first (the library
+ * boots locked on the boot screen, where every widget update is held). All
+ * scenarios but powersave keep the UI ACTIVE, so dimming never starts mid-run.
+ *
+ * Keep the device still and untouched while it runs: touches and IMU rotations
+ * change the numbers.
+ *
+ * Hardware Requirements:
+ * - ESP32 microcontroller
+ * - SH8601 AMOLED display (280×456 pixels)
+ * - FT3168 touch controller
+ *
+ * Dependencies:
+ * - HomeWindWSAmoled, LVGL
+ */
+
+#include <HomeWindWSAmoled.h>
+#include <stdio.h>
+
+static const uint32_t SETTLE_MS = 1500;  // Between scenarios: animations finish, timers idle
+
+typedef struct {
+  const char *name;
+  uint32_t duration_ms;
+  uint32_t step_ms;
+  void (*step)(uint32_t n);  // Called every step_ms, n = 0, 1, 2, ...
+  bool keep_active;          // Hold off DIMMED (the powersave scenario drives the states itself)
+} scenario_t;
+
+static const uint32_t KEEP_ACTIVE_MS = 1000;  // Well below the powersave dim timeout
+static lv_obj_t *mainScreen = NULL;
+
+/* LVGL calls from the Arduino task need the LVGL lock */
+static void runLocked(void (*fn)(void)) {
+  if (lcd_lvgl_lock(-1)) {
+    fn();
+    lcd_lvgl_unlock();
+  }
+}
+
+/* --- Scenario steps --- */
+static void stepIdle(uint32_t n) {
+  (void)n;
+}
+
+static void stepHr(uint32_t n) {
+  homewind_set_hr_value(70 + (n * 7) % 60);
+}
+
+static void stepCadence(uint32_t n) {
+  homewind_set_csc_cadence(60 + (n * 13) % 60);
+}
+
+static void stepFans(uint32_t n) {
+  for (uint8_t i = 0; i < 4; i++) homewind_set_fan_toggle(i, (n & 1) == 0);
+}
+
+static void stepModal(uint32_t n) {
+  runLocked((n & 1) == 0 ? homewind_show_settings_overlay : homewind_close_settings_overlay);
+}
+
+static void stepRotation(uint32_t n) {
+  static const lv_disp_rot_t rotations[] = { LV_DISP_ROT_90, LV_DISP_ROT_180, LV_DISP_ROT_270, LV_DISP_ROT_NONE };
+  homewind_set_rotation(rotations[n % 4]);
+}
+
+static void stepPowersave(uint32_t n) {
+  switch (n % 6) {
+    case 0: runLocked(set_state_soft_powersave); break;
+    case 2: runLocked(on_user_activity); break;
+    case 3: runLocked(set_state_panel_off); break;        // LVGL suspends after this pass
+    case 5: lcd_lvgl_wake(); break;                       // What a setter does with new sensor data
+    default: break;
+  }
+}
+
+static const scenario_t scenarios[] = {
+  { "idle",          10000, 1000, stepIdle,      true },
+  { "hr_4hz",        10000,  250, stepHr,        true },
+  { "cadence_storm", 10000,    5, stepCadence,   true },
+  { "fan_toggle",    10000,  200, stepFans,      true },
+  { "modal",         10500,  700, stepModal,     true },
+  { "rotation",      12000, 1000, stepRotation,  true },
+  { "powersave",     12000, 1000, stepPowersave, false },
+};
+static const int SCENARIO_COUNT = sizeof(scenarios) / sizeof(scenarios[0]);
+
+/* Boot screen -> main screen; until then every widget update is held */
+static void showMain() {
+  homewind_show_main_screen();
+  mainScreen = lv_scr_act();
+  powersave_unlock();
+}
+
+/* Known start state: main screen, all widgets active, nothing open, portrait.
+ * false if the main screen is not shown (updates would be held, numbers meaningless) */
+static bool resetUi() {
+  homewind_set_hr(HR_STATE_ACTIVE, "TickrFit", 80);
+  homewind_set_csc(CSC_STATE_ACTIVE, "Wahoo Cadence", 85);
+  for (uint8_t i = 0; i < 4; i++) homewind_set_fan(i, FAN_STATE_ACTIVE, false);
+  homewind_set_rotation(LV_DISP_ROT_NONE);
+  runLocked(homewind_close_settings_overlay);
+  runLocked(on_user_activity);
+
+  bool onMain = false;
+  if (lcd_lvgl_lock(-1)) {
+    onMain = (mainScreen != NULL && lv_scr_act() == mainScreen);
+    lcd_lvgl_unlock();
+  }
+  return onMain;
+}
+
+/* false only if perf stats are compiled out: a read that raced the LVGL task is retried */
+static bool readPerfStats(homewind_perf_stats_t *p) {
+  for (int i = 0; i < 10; i++) {
+    if (homewind_get_perf_stats(p)) return true;
+    delay(1);
+  }
+  return false;
+}
+
+static void runScenario(const scenario_t *sc) {
+  if (!resetUi()) {
+    printf("BENCH_ERROR scenario=%s reason=main_screen_not_active\n", sc->name);
+    fflush(stdout);
+    return;
+  }
+  delay(SETTLE_MS);
+
+  homewind_mem_stats_t before;
+  homewind_get_mem_stats(&before);
+  homewind_reset_perf_stats();
+
+  uint32_t start = millis();
+  uint32_t next = start;
+  uint32_t lastActivity = start;
+  for (uint32_t n = 0; millis() - start < sc->duration_ms; n++) {
+    if (sc->keep_active && millis() - lastActivity >= KEEP_ACTIVE_MS) {
+      runLocked(on_user_activity);
+      lastActivity = millis();
+    }
+    sc->step(n);
+    next += sc->step_ms;
+    int32_t wait = (int32_t)(next - millis());
+    if (wait > 0) delay(wait);
+  }
+
+  homewind_perf_stats_t p;
+  readPerfStats(&p);
+  homewind_mem_stats_t after;
+  homewind_get_mem_stats(&after);
+
+  printf("BENCH scenario=%s window_ms=%lu frames=%lu fps=%.1f render_avg_us=%lu render_p99_us=%lu render_max_us=%lu"
+         " flushes=%lu flush_bytes=%llu flush_avg_us=%lu cpu_pct=%u handler_max_us=%lu touch_polls=%lu i2c_errors=%lu"
+         " heap_delta=%ld heap_min_free=%lu largest_delta=%ld dma_delta=%ld psram_delta=%ld\n",
+         sc->name, (unsigned long)p.window_ms, (unsigned long)p.frames, (double)p.fps,
+         (unsigned long)p.render_avg_us, (unsigned long)p.render_p99_us, (unsigned long)p.render_max_us,
+         (unsigned long)p.flushes, (unsigned long long)p.flush_bytes, (unsigned long)p.flush_avg_us,
+         p.lvgl_cpu_pct, (unsigned long)p.handler_period_max_us, (unsigned long)p.touch_polls,
+         (unsigned long)p.i2c_errors,
+         (long)after.internal.free - (long)before.internal.free, (unsigned long)after.internal.min_free,
+         (long)after.internal.largest - (long)before.internal.largest,
+         (long)after.dma.free - (long)before.dma.free, (long)after.psram.free - (long)before.psram.free);
+  fflush(stdout);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+
+  homewind_init();
+  homewind_set_qr_code_url("https://homewind.example.com/setup");
+  runLocked(showMain);
+
+  homewind_perf_stats_t probe;
+  if (!readPerfStats(&probe)) {
+    printf("BENCH_ERROR reason=perf_stats_disabled\n");
+    fflush(stdout);
+    return;
+  }
+
+  printf("BENCH_BEGIN version=%s scenarios=%d\n", HOMEWIND_WS_AMOLED_VERSION, SCENARIO_COUNT);
+  fflush(stdout);
+  for (int i = 0; i < SCENARIO_COUNT; i++) {
+    runScenario(&scenarios[i]);
+  }
+  resetUi();
+  printf("BENCH_END\n");
+  fflush(stdout);
+}
+
+void loop() {
+  delay(1000);
+}
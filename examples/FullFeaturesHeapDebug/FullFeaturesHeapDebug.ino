@@ -1,20 +1,31 @@
 /*
  * FullFeaturesHeapDebug.ino
  *
- * Same as FullFeatures example, plus heap debug log every 30 seconds:
- *   [Heap] TICK 01:29:43: free=95984, largest=49140, frag=48.8%, drift=2912, minFree=73748
+ * Same as FullFeatures example, plus a memory report every 30 seconds from
+ * homewind_get_mem_stats():
+ *   [Heap] TICK 01:29:43: free=95984, largest=49140, frag=48.8%, drift=2912, minFree=73748, minLargest=40960
+ *   [Heap] TICK 01:29:43: free_psram=..., largest_psram=...
+ *   [Heap] TICK 01:29:43: free_dma=..., largest_dma=...
+ *   [Heap] TICK 01:29:43: lvgl used=38%, frag=4%, max_used=..., max_frag=9%
+ *   [Heap] LIB draw_buffers=63840 screens=... fonts=... qr=... history=... tasks=8192
  *
- * All values refer to INTERNAL RAM only (MALLOC_CAP_INTERNAL), so frag is meaningful
+ * The first line covers INTERNAL RAM only (MALLOC_CAP_INTERNAL), so frag is meaningful
  * even when LVGL uses PSRAM (otherwise largest would be PSRAM and frag would be wrong).
  *
- * - TICK   = uptime HH:MM:SS
- * - free   = free internal heap (bytes)
- * - largest= largest contiguous free block in internal heap (bytes)
- * - frag   = internal heap fragmentation % = (1 - largest/free)*100
- * - drift  = change in free internal heap since last log (bytes)
- * - minFree= minimum free internal heap seen since start (bytes)
+ * - TICK      = uptime HH:MM:SS
+ * - free      = free internal heap (bytes)
+ * - largest   = largest contiguous free block in internal heap (bytes)
+ * - frag      = internal heap fragmentation % = (1 - largest/free)*100
+ * - drift     = change in free internal heap since last log (bytes)
+ * - minFree   = minimum free internal heap since boot (bytes)
+ * - minLargest= smallest largest-block seen by the library sampler (bytes)
  *
- * If PSRAM is present, a second line reports PSRAM: free_psram=..., largest_psram=...
+ * The PSRAM line appears only if PSRAM is present; the lvgl line needs LVGL's own
+ * pool (LV_MEM_CUSTOM 0, e.g. extras/lv_conf_arena.h). LIB is printed once after setup.
+ *
+ * Zero-heap mode: with HOMEWIND_ZERO_HEAP 1 (lcd_config.h), extras/lv_conf_arena.h in
+ * lv_conf.h and CONFIG_HEAP_USE_HOOKS, any heap call by the library tasks after
+ * homewind_init() is printed as [Heap] STRAY ... (homewind_set_alloc_hook()).
  *
  * Hardware Requirements:
  * - ESP32 microcontroller
@@ -26,46 +37,49 @@
  */
 
 #include <HomeWindWSAmoled.h>
-#include <esp_heap_caps.h>
 #include <stdio.h>
 
 /* Use printf() so output appears on same channel as library (qmi8658_log = printf). */
 
 static const unsigned long HEAP_LOG_INTERVAL_MS = 30000;  // 30 seconds
 
-/* Shared with setup() so first loop() log after 30s has correct drift/minFree */
+/* Shared with setup() so first loop() log after 30s has correct drift */
 static uint32_t s_lastFree = 0;
-static uint32_t s_minFree = UINT32_MAX;
 static unsigned long s_lastLogMs = 0;
 
-/* Print one [Heap] line (internal RAM only). Uses printf() so it appears on same UART as library. */
-static void printHeapLine(unsigned long nowMs, uint32_t freeBytes, size_t largestBytes,
-                          int32_t drift, uint32_t minFree) {
-  float fragPct = (freeBytes > 0) ? (1.0f - (float)largestBytes / (float)freeBytes) * 100.0f : 0.0f;
+/* Print the [Heap] lines of one report. Uses printf() so it appears on same UART as library. */
+static void printMemStats(unsigned long nowMs, const homewind_mem_stats_t *st, int32_t drift) {
+  const homewind_heap_stats_t *in = &st->internal;
+  float fragPct = (in->free > 0) ? (1.0f - (float)in->largest / (float)in->free) * 100.0f : 0.0f;
   unsigned long totalSec = nowMs / 1000;
   unsigned int h = (unsigned int)(totalSec / 3600);
   unsigned int m = (unsigned int)((totalSec % 3600) / 60);
   unsigned int s = (unsigned int)(totalSec % 60);
 
-  printf("[Heap] TICK %02u:%02u:%02u: free=%lu, largest=%u, frag=%.1f%%, drift=%ld, minFree=%lu\n",
-         (unsigned)h, (unsigned)m, (unsigned)s,
-         (unsigned long)freeBytes, (unsigned)largestBytes, (double)fragPct,
-         (long)drift, (unsigned long)minFree);
+  printf("[Heap] TICK %02u:%02u:%02u: free=%lu, largest=%lu, frag=%.1f%%, drift=%ld, minFree=%lu, minLargest=%lu\n",
+         h, m, s, (unsigned long)in->free, (unsigned long)in->largest, (double)fragPct,
+         (long)drift, (unsigned long)in->min_free, (unsigned long)in->min_largest);
+  if (st->psram.total > 0) {
+    printf("[Heap] TICK %02u:%02u:%02u: free_psram=%lu, largest_psram=%lu\n",
+           h, m, s, (unsigned long)st->psram.free, (unsigned long)st->psram.largest);
+  }
+  printf("[Heap] TICK %02u:%02u:%02u: free_dma=%lu, largest_dma=%lu\n",
+         h, m, s, (unsigned long)st->dma.free, (unsigned long)st->dma.largest);
+  if (st->lvgl.total > 0) {
+    printf("[Heap] TICK %02u:%02u:%02u: lvgl used=%u%%, frag=%u%%, max_used=%lu, max_frag=%u%%\n",
+           h, m, s, st->lvgl.used_pct, st->lvgl.frag_pct,
+           (unsigned long)st->lvgl.max_used, st->lvgl.max_frag_pct);
+  }
   fflush(stdout);
 }
 
-/* Print PSRAM stats when available (one line). */
-static void printPsramLine(unsigned long nowMs) {
-  size_t freePsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
-  size_t largestPsram = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
-  if (freePsram == 0 && largestPsram == 0) return;  /* No PSRAM */
-  unsigned long totalSec = nowMs / 1000;
-  unsigned int h = (unsigned int)(totalSec / 3600);
-  unsigned int m = (unsigned int)((totalSec % 3600) / 60);
-  unsigned int s = (unsigned int)(totalSec % 60);
-  printf("[Heap] TICK %02u:%02u:%02u: free_psram=%u, largest_psram=%u\n",
-         (unsigned)h, (unsigned)m, (unsigned)s,
-         (unsigned)freePsram, (unsigned)largestPsram);
+/* Per-subsystem footprint of the library (fixed after init). */
+static void printLibFootprint(const homewind_mem_stats_t *st) {
+  printf("[Heap] LIB");
+  for (int i = 0; i < HOMEWIND_MEM_SUBSYS_COUNT; i++) {
+    printf(" %s=%lu", homewind_mem_subsys_name((homewind_mem_subsys_t)i), (unsigned long)st->subsys[i]);
+  }
+  printf("\n");
   fflush(stdout);
 }
 
@@ -76,18 +90,14 @@ static void logHeapDebug() {
   if (now - s_lastLogMs < HEAP_LOG_INTERVAL_MS) return;
   s_lastLogMs = now;
 
-  /* Internal RAM only so frag is correct when LVGL uses PSRAM (MALLOC_CAP_8BIT would mix heaps). */
-  uint32_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
-  size_t largestBytes = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
-
-  if (freeBytes < s_minFree) s_minFree = freeBytes;
+  homewind_mem_stats_t st;
+  homewind_get_mem_stats(&st);
 
-  int32_t drift = firstRun ? 0 : (int32_t)freeBytes - (int32_t)s_lastFree;
+  int32_t drift = firstRun ? 0 : (int32_t)st.internal.free - (int32_t)s_lastFree;
   if (firstRun) firstRun = false;
-  s_lastFree = freeBytes;
+  s_lastFree = st.internal.free;
 
-  printHeapLine(now, freeBytes, largestBytes, drift, s_minFree);
-  printPsramLine(now);
+  printMemStats(now, &st, drift);
 }
 
 void setup() {
@@ -96,6 +106,11 @@ void setup() {
 
   /* Init library first (its printf/qmi8658_log output appears here). */
   homewind_init();
+  homewind_set_alloc_hook([](const homewind_stray_alloc_t *info) {
+    printf("[Heap] STRAY %s %u bytes in %s (#%lu)\n", info->size ? "alloc" : "free",
+           (unsigned)info->size, info->task, (unsigned long)info->count);
+    fflush(stdout);
+  });
   homewind_set_qr_code_url("https://homewind.example.com/setup");
 
   homewind_set_hr(HR_STATE_INACTIVE, "TickrFit", 0);
@@ -112,18 +127,17 @@ void setup() {
 
   /* Use printf() so output appears on same UART as library (qmi8658_log). */
   printf("\n--- FullFeaturesHeapDebug ---\n");
-  printf("Heap log every 30s: [Heap] TICK HH:MM:SS: free=..., largest=..., frag=..., drift=..., minFree=...\n");
+  printf("Heap log every 30s: [Heap] TICK HH:MM:SS: free=..., largest=..., frag=..., drift=..., minFree=..., minLargest=...\n");
   fflush(stdout);
 
-  /* First heap line right after setup (then every 30s in loop). Internal RAM only. */
+  /* First report right after setup (then every 30s in loop). */
   {
+    homewind_mem_stats_t st;
+    homewind_get_mem_stats(&st);
     unsigned long now = millis();
-    uint32_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
-    size_t largestBytes = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
-    printHeapLine(now, freeBytes, largestBytes, 0, freeBytes);
-    printPsramLine(now);
-    s_lastFree = freeBytes;
-    s_minFree = freeBytes;
+    printMemStats(now, &st, 0);
+    printLibFootprint(&st);
+    s_lastFree = st.internal.free;
     s_lastLogMs = now;
   }
   printf("Setup complete.\n");
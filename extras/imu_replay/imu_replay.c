@@ -0,0 +1,321 @@
+// imu_replay.c - host replay of IMU traces through the rotation decision
+//
+// Build (from this directory):
+//   cc -O2 -I../../src -o imu_replay imu_replay.c ../../src/imu_rotation.c ../../src/imu_fusion.c
+//
+// Usage: imu_replay [-4] [-g] [-t right,left] [-w window_ms] [-n iterations] [-v] trace...
+//
+// Feeds each record of a trace recorded with imu_trace_start() through imu_rotation_process(),
+// the code the IMU rotation task runs on the device, and scores the decisions against ground
+// truth: imu_trace_mark() markers when the trace has them, otherwise a non-causal reference
+// (orientation of the centered mean over the window). Same trace + same code gives the same
+// numbers, so filter changes can be compared run against run.
+#include "imu_rotation.h"
+#include "imu_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define DEFAULT_WINDOW_MS   2000
+#define DEFAULT_ITERATIONS  20
+#define REF_DEADBAND        10      /* Reference: percent of 1 g around 0 that keeps the label */
+#define ROT_UNKNOWN         0xFF
+
+typedef struct {
+    bool four_way;
+    bool use_gyro;
+    float tilt_right;
+    float tilt_left;
+    uint32_t window_ms;
+    int iterations;
+    bool verbose;
+} replay_opts_t;
+
+typedef struct {
+    imu_trace_header_t hdr;
+    imu_trace_record_t *recs;
+    size_t count;
+    uint32_t *t_ms;         /* Absolute time of each record */
+    uint8_t *truth;         /* Expected rotation per record (ROT_UNKNOWN = not scored) */
+    bool has_marks;
+} trace_t;
+
+static const int rot_deg[4] = { 0, 90, 180, 270 };
+
+/* ============================================================================
+ * Loading
+ * ============================================================================ */
+
+static bool trace_load(const char *path, trace_t *t)
+{
+    memset(t, 0, sizeof(*t));
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    if (fread(&t->hdr, sizeof(t->hdr), 1, f) != 1 ||
+        memcmp(t->hdr.magic, IMU_TRACE_MAGIC, 4) != 0 || t->hdr.version != IMU_TRACE_VERSION) {
+        fprintf(stderr, "%s: not an IMU trace (version %d)\n", path, IMU_TRACE_VERSION);
+        fclose(f);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long bytes = ftell(f) - (long)sizeof(t->hdr);
+    fseek(f, sizeof(t->hdr), SEEK_SET);
+
+    t->count = (size_t)bytes / sizeof(imu_trace_record_t);
+    t->recs = calloc(t->count ? t->count : 1, sizeof(imu_trace_record_t));
+    t->t_ms = calloc(t->count ? t->count : 1, sizeof(uint32_t));
+    t->truth = calloc(t->count ? t->count : 1, 1);
+    if (!t->recs || !t->t_ms || !t->truth ||
+        fread(t->recs, sizeof(imu_trace_record_t), t->count, f) != t->count) {
+        fprintf(stderr, "%s: read error\n", path);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    uint32_t now = 0;
+    for (size_t i = 0; i < t->count; i++) {
+        now += t->recs[i].dt_ms;
+        t->t_ms[i] = now;
+        if (t->recs[i].flags & IMU_TRACE_REC_MARK) t->has_marks = true;
+    }
+    return true;
+}
+
+static void trace_free(trace_t *t)
+{
+    free(t->recs);
+    free(t->t_ms);
+    free(t->truth);
+}
+
+/* ============================================================================
+ * Ground Truth
+ * ============================================================================ */
+
+static void truth_from_marks(trace_t *t)
+{
+    uint8_t cur = ROT_UNKNOWN;
+    for (size_t i = 0; i < t->count; i++) {
+        if (t->recs[i].flags & IMU_TRACE_REC_MARK) cur = (uint8_t)(t->recs[i].acc[0] & 3);
+        t->truth[i] = cur;
+    }
+}
+
+/* Reference label: orientation of the centered mean over the window (non-causal, so it
+ * switches at the middle of a turn). Inside the deadband it keeps the label. */
+static void truth_from_reference(trace_t *t, const imu_rotation_t *thr, const replay_opts_t *o)
+{
+    int64_t deadband = (int64_t)t->hdr.acc_lsb * REF_DEADBAND / 100;
+    uint32_t half = o->window_ms / 2;
+    uint8_t cur = ROT_UNKNOWN;
+    size_t lo = 0, hi = 0;
+    int64_t sum[3] = { 0, 0, 0 };
+    int64_t n = 0;
+
+    for (size_t i = 0; i < t->count; i++) {
+        /* Slide [lo, hi) to cover t_ms[i] +/- half */
+        while (hi < t->count && t->t_ms[hi] <= t->t_ms[i] + half) {
+            if (!(t->recs[hi].flags & IMU_TRACE_REC_MARK)) {
+                for (int k = 0; k < 3; k++) sum[k] += t->recs[hi].acc[k];
+                n++;
+            }
+            hi++;
+        }
+        while (t->t_ms[lo] + half < t->t_ms[i]) {
+            if (!(t->recs[lo].flags & IMU_TRACE_REC_MARK)) {
+                for (int k = 0; k < 3; k++) sum[k] -= t->recs[lo].acc[k];
+                n--;
+            }
+            lo++;
+        }
+        if (n > 0) {
+            int64_t x = sum[0] / n, y = sum[1] / n;
+            int64_t ax = llabs(x), ay = llabs(y);
+            if (o->four_way && ay > ax + thr->axis_margin) {
+                cur = (y > 0) ? 1 : 3;
+            } else if (!o->four_way || ax > ay + thr->axis_margin) {
+                if (x > deadband) cur = 0;
+                else if (x < -deadband) cur = 2;
+            }
+        }
+        t->truth[i] = cur;
+    }
+
+    /* Orientations held for less than one window are noise in the reference: keep the previous one */
+    size_t start = 0;
+    for (size_t i = 1; i <= t->count; i++) {
+        if (i < t->count && t->truth[i] == t->truth[start]) continue;
+        uint32_t end_ms = (i < t->count) ? t->t_ms[i] : t->t_ms[t->count - 1] + o->window_ms;
+        if (start > 0 && end_ms - t->t_ms[start] < o->window_ms) {
+            memset(&t->truth[start], t->truth[start - 1], i - start);
+        }
+        start = i;
+    }
+}
+
+/* ============================================================================
+ * Replay
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t rotations;
+    uint32_t false_rotations;
+    uint32_t truth_changes;
+    uint32_t missed;
+    uint32_t face_down;
+    uint64_t latency_sum_ms;
+    uint32_t latency_max_ms;
+    uint32_t latency_n;
+    uint64_t samples;
+    double ns_per_batch;
+} replay_stats_t;
+
+static uint8_t replay_once(const trace_t *t, const replay_opts_t *o, uint8_t *events)
+{
+    imu_rotation_t rot;
+    bool gyro = o->use_gyro && (t->hdr.flags & IMU_TRACE_HDR_GYRO);
+    memset(&rot, 0, sizeof(rot));
+    imu_rotation_init(&rot, 0, t->hdr.acc_lsb, gyro ? t->hdr.gyro_lsb : 0);
+    imu_rotation_set_thresholds(&rot, o->tilt_right, o->tilt_left, t->hdr.acc_lsb);
+    rot.four_way = o->four_way;
+
+    for (size_t i = 0; i < t->count; i++) {
+        const imu_trace_record_t *r = &t->recs[i];
+        if (r->flags & IMU_TRACE_REC_MARK) {
+            if (events) events[i] = 0;
+            continue;
+        }
+        int16_t acc[3], g[3];
+        memcpy(acc, r->acc, sizeof(acc));  /* Packed record: copy to aligned arrays */
+        memcpy(g, r->gyro, sizeof(g));
+        uint8_t evt = imu_rotation_process(&rot, acc, (gyro && (r->flags & IMU_TRACE_REC_GYRO)) ? g : NULL,
+                                           imu_rotation_batch_ms(r->samples, t->hdr.odr_dhz), true);
+        if (events) events[i] = evt | (uint8_t)(rot.current << 4);
+    }
+    return rot.current;
+}
+
+static void replay_score(const trace_t *t, const replay_opts_t *o, replay_stats_t *s)
+{
+    uint8_t *events = calloc(t->count ? t->count : 1, 1);
+    replay_once(t, o, events);
+
+    uint8_t truth = ROT_UNKNOWN;
+    uint32_t change_ms = 0;
+    bool change_open = false;  /* Truth changed, device not there yet */
+
+    for (size_t i = 0; i < t->count; i++) {
+        if (t->truth[i] != truth) {
+            if (change_open) s->missed++;
+            change_open = (truth != ROT_UNKNOWN && t->truth[i] != ROT_UNKNOWN);
+            if (change_open) s->truth_changes++;
+            truth = t->truth[i];
+            change_ms = t->t_ms[i];
+            if (o->verbose && truth != ROT_UNKNOWN) {
+                printf("  %8.2f s  truth %3d deg\n", change_ms / 1000.0, rot_deg[truth]);
+            }
+        }
+        if (!(t->recs[i].flags & IMU_TRACE_REC_MARK)) s->samples += t->recs[i].samples;
+
+        uint8_t evt = events[i] & 0x0F;
+        uint8_t cur = events[i] >> 4;
+        if (evt & IMU_ROTATION_EVT_FACE_DOWN) s->face_down++;
+        if (!(evt & IMU_ROTATION_EVT_ROTATE)) continue;
+
+        s->rotations++;
+        bool wrong = (truth != ROT_UNKNOWN && cur != truth);
+        if (wrong) s->false_rotations++;
+        if (o->verbose) {
+            printf("  %8.2f s  -> %3d deg%s\n", t->t_ms[i] / 1000.0, rot_deg[cur & 3], wrong ? "  FALSE" : "");
+        }
+        if (change_open && cur == truth) {
+            uint32_t lat = t->t_ms[i] - change_ms;
+            s->latency_sum_ms += lat;
+            s->latency_n++;
+            if (lat > s->latency_max_ms) s->latency_max_ms = lat;
+            change_open = false;
+        }
+    }
+    if (change_open) s->missed++;
+    free(events);
+
+    /* CPU: whole trace, several passes, per batch and per sample */
+    struct timespec a, b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int k = 0; k < o->iterations; k++) replay_once(t, o, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double ns = (b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec);
+    s->ns_per_batch = t->count ? ns / ((double)t->count * o->iterations) : 0.0;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: imu_replay [-4] [-g] [-t right,left] [-w window_ms] [-n iterations] [-v] trace...\n"
+            "  -4   four-way rotation (homewind_set_imu_four_way)\n"
+            "  -g   ignore recorded gyro (accelerometer-only fusion)\n"
+            "  -t   tilt thresholds in m/s^2 (default 1.0,-1.0)\n"
+            "  -w   reference window when the trace has no markers (default %d ms)\n"
+            "  -n   passes for the CPU measurement (default %d)\n"
+            "  -v   list every rotation\n", DEFAULT_WINDOW_MS, DEFAULT_ITERATIONS);
+}
+
+int main(int argc, char **argv)
+{
+    replay_opts_t o = { false, true, 1.0f, -1.0f, DEFAULT_WINDOW_MS, DEFAULT_ITERATIONS, false };
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-4")) o.four_way = true;
+        else if (!strcmp(argv[i], "-g")) o.use_gyro = false;
+        else if (!strcmp(argv[i], "-v")) o.verbose = true;
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            if (sscanf(argv[++i], "%f,%f", &o.tilt_right, &o.tilt_left) != 2) { usage(); return 2; }
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) o.window_ms = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) o.iterations = atoi(argv[++i]);
+        else { usage(); return 2; }
+    }
+    if (i == argc || o.iterations < 1) {
+        usage();
+        return 2;
+    }
+
+    int rc = 0;
+    for (; i < argc; i++) {
+        trace_t t;
+        if (!trace_load(argv[i], &t)) {
+            rc = 1;
+            continue;
+        }
+        imu_rotation_t thr;
+        imu_rotation_set_thresholds(&thr, o.tilt_right, o.tilt_left, t.hdr.acc_lsb);
+        if (t.has_marks) truth_from_marks(&t);
+        else truth_from_reference(&t, &thr, &o);
+
+        replay_stats_t s;
+        memset(&s, 0, sizeof(s));
+        uint32_t dur = t.count ? t.t_ms[t.count - 1] : 0;
+        printf("%s: %zu records, %u:%02u min, %s, truth from %s\n", argv[i], t.count,
+               dur / 60000, (dur / 1000) % 60,
+               (o.use_gyro && (t.hdr.flags & IMU_TRACE_HDR_GYRO)) ? "gyro" : "accel only",
+               t.has_marks ? "markers" : "reference");
+        replay_score(&t, &o, &s);
+        printf("  rotations %u  false %u  missed %u of %u  latency mean %u ms  max %u ms\n",
+               s.rotations, s.false_rotations, s.missed, s.truth_changes,
+               s.latency_n ? (unsigned)(s.latency_sum_ms / s.latency_n) : 0, s.latency_max_ms);
+        printf("  face-down %u  cpu %.0f ns/batch  %.1f ns/sample (host)\n", s.face_down, s.ns_per_batch,
+               s.samples ? s.ns_per_batch * (double)t.count / (double)s.samples : 0.0);
+        trace_free(&t);
+    }
+    return rc;
+}
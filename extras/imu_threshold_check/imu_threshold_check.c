@@ -0,0 +1,298 @@
+// imu_threshold_check.c - host check: raw-count rotation decision vs. the float thresholds
+//
+// Build (from this directory):
+//   cc -O2 -I../../src -o imu_threshold_check imu_threshold_check.c ../../src/imu_rotation.c ../../src/imu_fusion.c -lm
+//
+// Usage: imu_threshold_check [-v]
+//
+// The IMU task decides on raw int16 counts against thresholds converted once by
+// imu_rotation_set_thresholds(); before that it compared m/s² floats. This feeds the same
+// samples to both and fails (exit 1) if they ever disagree by more than the rounding of a
+// threshold to whole counts:
+//
+//   1. every raw value -32768..32767 against the single-axis thresholds
+//   2. synthetic batch sequences (tilt sweeps, noise, slow threshold crossings) through
+//      imu_rotation_process(), with a float reference of the decision + debounce fed the
+//      same fused gravity vector and batch mean
+//
+// Deterministic (fixed LCG seed), so a failure reproduces run for run.
+#include "imu_rotation.h"
+#include "imu_fusion.h"
+#include "qmi8658c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#define ONE_G_MS2           QMI8658_ONE_G  /* The driver's constant; the rounding is done here in float */
+#define BATCH_MS            190     /* 4 samples at 21 Hz */
+#define SEQ_BATCHES         20000
+#define ROUND_TOLERANCE     0.5f    /* Counts: a threshold is rounded to the nearest count */
+#define NEAR_COUNTS         1.0f    /* Sequence check: float and raw may differ this close to a threshold */
+
+#define ROT_0     0
+#define ROT_90    1
+#define ROT_180   2
+#define ROT_270   3
+
+typedef struct {
+    uint16_t lsb;           /* Accelerometer counts per g */
+    float tilt_right;
+    float tilt_left;
+} check_cfg_t;
+
+static const check_cfg_t configs[] = {
+    { 16384, 1.0f, -1.0f },     /* ±2 g, library defaults */
+    { 16384, 0.5f, -0.5f },
+    { 8192,  2.0f, -2.0f },     /* ±4 g */
+    { 4096,  3.0f, -0.2f },     /* ±8 g, asymmetric */
+    { 2048,  1.0f, -1.0f },     /* ±16 g: coarse counts */
+    { 16384, 19.5f, -19.5f },   /* Thresholds at the edge of the ±2 g range */
+};
+#define CONFIG_COUNT (sizeof(configs) / sizeof(configs[0]))
+
+static bool verbose = false;
+
+static float to_ms2(int32_t counts, uint16_t lsb)
+{
+    return (float)counts * ONE_G_MS2 / lsb;
+}
+
+static float to_counts(float ms2, uint16_t lsb)
+{
+    return ms2 * lsb / ONE_G_MS2;
+}
+
+/* ============================================================================
+ * 1. Single axis, every raw value
+ * ============================================================================ */
+
+static int check_exhaustive(const check_cfg_t *c)
+{
+    imu_rotation_t r;
+    memset(&r, 0, sizeof(r));
+    imu_rotation_set_thresholds(&r, c->tilt_right, c->tilt_left, c->lsb);
+
+    const float normal_ms2 = c->tilt_right + IMU_ROTATION_HYSTERESIS;
+    const float flipped_ms2 = c->tilt_left - IMU_ROTATION_HYSTERESIS;
+    const float normal_counts = to_counts(normal_ms2, c->lsb);
+    const float flipped_counts = to_counts(flipped_ms2, c->lsb);
+    int rounding = 0, failures = 0;
+
+    for (int32_t raw = -32768; raw <= 32767; raw++) {
+        float v = to_ms2(raw, c->lsb);
+        bool f_normal = v > normal_ms2, i_normal = raw > r.enter_normal;
+        bool f_flipped = v < flipped_ms2, i_flipped = raw < r.enter_flipped;
+        if (f_normal != i_normal) {
+            if (fabsf(raw - normal_counts) <= ROUND_TOLERANCE) rounding++;
+            else if (failures++ < 5) printf("  FAIL raw %ld: enter_normal float %d, raw %d\n", (long)raw, f_normal, i_normal);
+        }
+        if (f_flipped != i_flipped) {
+            if (fabsf(raw - flipped_counts) <= ROUND_TOLERANCE) rounding++;
+            else if (failures++ < 5) printf("  FAIL raw %ld: enter_flipped float %d, raw %d\n", (long)raw, f_flipped, i_flipped);
+        }
+    }
+    printf("  exhaustive: 65536 values, %d at a rounded threshold, %d failures\n", rounding, failures);
+    return failures;
+}
+
+/* ============================================================================
+ * 2. Batch sequences through imu_rotation_process()
+ * ============================================================================ */
+
+/* Float reference: the m/s² decision the task made before the integer path */
+typedef struct {
+    bool four_way;
+    float enter_normal;
+    float enter_flipped;
+    uint8_t current;
+    uint8_t pending;
+    uint8_t stable_count;
+} ref_t;
+
+static uint8_t ref_target(const ref_t *f, const float g[3])
+{
+    uint8_t current = f->current;
+    bool landscape = (current == ROT_90 || current == ROT_270);
+
+    if (f->four_way) {
+        float ax = fabsf(g[0]), ay = fabsf(g[1]);
+        if (!landscape && ay > ax + IMU_ROTATION_AXIS_MARGIN) return (g[1] > 0) ? ROT_90 : ROT_270;
+        if (landscape && ax > ay + IMU_ROTATION_AXIS_MARGIN) return (g[0] > 0) ? ROT_0 : ROT_180;
+    } else if (landscape) {
+        return (g[0] >= 0) ? ROT_0 : ROT_180;
+    }
+    if (landscape) {
+        if (current == ROT_90 && g[1] < f->enter_flipped) return ROT_270;
+        if (current == ROT_270 && g[1] > f->enter_normal) return ROT_90;
+        return current;
+    }
+    if (current == ROT_0) return (g[0] < f->enter_flipped) ? ROT_180 : current;
+    return (g[0] > f->enter_normal) ? ROT_0 : current;
+}
+
+static void ref_step(ref_t *f, const float g[3], const float acc[3])
+{
+    uint8_t target = ref_target(f, g);
+    uint8_t needed = (ref_target(f, acc) == target) ? 1 : IMU_ROTATION_STABLE_COUNT;
+    if (target == f->current) {
+        f->stable_count = 0;
+        return;
+    }
+    if (target != f->pending) {
+        f->pending = target;
+        f->stable_count = 0;
+    }
+    if (++f->stable_count >= needed) {
+        f->current = target;
+        f->stable_count = 0;
+    }
+}
+
+/* Any compared quantity within NEAR_COUNTS of its threshold: rounding may flip the result */
+static bool near_vector(const ref_t *f, const int16_t g[3], uint16_t lsb)
+{
+    const float normal = to_counts(f->enter_normal, lsb);
+    const float flipped = to_counts(f->enter_flipped, lsb);
+    const float margin = to_counts(IMU_ROTATION_AXIS_MARGIN, lsb);
+    for (int i = 0; i < 2; i++) {
+        if (fabsf(g[i] - normal) <= NEAR_COUNTS || fabsf(g[i] - flipped) <= NEAR_COUNTS) return true;
+    }
+    float lead = (float)abs(g[1]) - abs(g[0]);
+    return f->four_way && (fabsf(lead - margin) <= NEAR_COUNTS || fabsf(-lead - margin) <= NEAR_COUNTS);
+}
+
+/* The fused vector picks the target, the batch mean how many batches it needs */
+static bool near_threshold(const ref_t *f, const int16_t g[3], const int16_t acc[3], uint16_t lsb)
+{
+    return near_vector(f, g, lsb) || near_vector(f, acc, lsb);
+}
+
+static uint32_t lcg_state;
+
+static float noise(float amplitude)
+{
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return amplitude * ((float)(lcg_state >> 8) / (float)(1u << 24) * 2.0f - 1.0f);
+}
+
+static int16_t clamp_counts(float counts)
+{
+    if (counts > 32767.0f) return 32767;
+    if (counts < -32768.0f) return -32768;
+    return (int16_t)lrintf(counts);
+}
+
+/* Crossing pattern: X walks between the two thresholds and back, in 1/4-count steps within
+ * CROSS_FINE_COUNTS of a threshold and coarse steps in between */
+#define CROSS_FINE_COUNTS   8.0f
+#define CROSS_COARSE_STEP   16.0f
+
+typedef struct {
+    float x;                /* Counts */
+    float dir;
+} crossing_t;
+
+/* Sample n of the sequence, in g: pattern 0 = roll sweep, 1 = slow crossing of the X thresholds */
+static void sequence_sample(int pattern, int n, const check_cfg_t *c, crossing_t *cross, float acc_g[3])
+{
+    if (pattern == 0) {
+        float theta = n * 0.035f;                               /* ~2 degrees per batch */
+        float tilt = 0.5f + 0.45f * sinf(n * 0.004f);           /* 0.05 .. 0.95 g off vertical */
+        acc_g[0] = tilt * cosf(theta) + noise(0.05f);
+        acc_g[1] = tilt * sinf(theta) + noise(0.05f);
+    } else {
+        float normal = to_counts(c->tilt_right + IMU_ROTATION_HYSTERESIS, c->lsb);
+        float flipped = to_counts(c->tilt_left - IMU_ROTATION_HYSTERESIS, c->lsb);
+        bool fine = fabsf(cross->x - normal) < CROSS_FINE_COUNTS || fabsf(cross->x - flipped) < CROSS_FINE_COUNTS;
+        cross->x += cross->dir * (fine ? 0.25f : CROSS_COARSE_STEP);
+        if (cross->x > normal + 2 * CROSS_FINE_COUNTS) cross->dir = -1.0f;
+        if (cross->x < flipped - 2 * CROSS_FINE_COUNTS) cross->dir = 1.0f;
+        acc_g[0] = cross->x / c->lsb;
+        acc_g[1] = noise(0.5f / c->lsb);
+    }
+    float xy2 = acc_g[0] * acc_g[0] + acc_g[1] * acc_g[1];
+    acc_g[2] = xy2 < 1.0f ? sqrtf(1.0f - xy2) : 0.0f;          /* Face up */
+}
+
+static int check_sequence(const check_cfg_t *c, int pattern, bool four_way)
+{
+    imu_rotation_t r;
+    memset(&r, 0, sizeof(r));
+    imu_rotation_init(&r, ROT_0, c->lsb, 0);
+    imu_rotation_set_thresholds(&r, c->tilt_right, c->tilt_left, c->lsb);
+    r.four_way = four_way;
+
+    ref_t f = { four_way, c->tilt_right + IMU_ROTATION_HYSTERESIS, c->tilt_left - IMU_ROTATION_HYSTERESIS,
+                ROT_0, ROT_0, 0 };
+    lcg_state = 12345u + pattern;
+    crossing_t cross = { 0.0f, -1.0f };
+    int rotations = 0, boundary = 0, failures = 0;
+
+    for (int n = 0; n < SEQ_BATCHES; n++) {
+        float acc_g[3];
+        sequence_sample(pattern, n, c, &cross, acc_g);
+        int16_t acc[3];
+        for (int i = 0; i < 3; i++) acc[i] = clamp_counts(acc_g[i] * c->lsb);
+
+        uint8_t evt = imu_rotation_process(&r, acc, NULL, BATCH_MS, true);
+        if (evt & IMU_ROTATION_EVT_ROTATE) rotations++;
+
+        /* Same fused gravity vector and batch mean for the float reference */
+        int16_t g[3];
+        imu_fusion_get_gravity(g);
+        float g_ms2[3] = { to_ms2(g[0], c->lsb), to_ms2(g[1], c->lsb), to_ms2(g[2], c->lsb) };
+        float acc_ms2[3] = { to_ms2(acc[0], c->lsb), to_ms2(acc[1], c->lsb), to_ms2(acc[2], c->lsb) };
+        ref_t before = f;
+        ref_step(&f, g_ms2, acc_ms2);
+
+        if (f.current == r.current && f.pending == r.pending && f.stable_count == r.stable_count) continue;
+        if (near_threshold(&before, g, acc, c->lsb)) {
+            boundary++;
+        } else if (failures++ < 5) {
+            printf("  FAIL batch %d: g %d,%d,%d  float %u/%u/%u  raw %u/%u/%u\n", n, g[0], g[1], g[2],
+                   f.current, f.pending, f.stable_count, r.current, r.pending, r.stable_count);
+        }
+        /* Continue from the device's state so one rounding case is not counted again */
+        f.current = r.current;
+        f.pending = r.pending;
+        f.stable_count = r.stable_count;
+    }
+    printf("  %-8s %s: %d batches, %d rotations, %d at a threshold, %d failures\n",
+           pattern == 0 ? "sweep" : "crossing", four_way ? "4-way" : "2-way",
+           SEQ_BATCHES, rotations, boundary, failures);
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failures = 0;
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+        const check_cfg_t *c = &configs[i];
+        printf("lsb %u, tilt %.2f / %.2f m/s2\n", c->lsb, (double)c->tilt_right, (double)c->tilt_left);
+        failures += check_exhaustive(c);
+        for (int pattern = 0; pattern < 2; pattern++) {
+            failures += check_sequence(c, pattern, false);
+            failures += check_sequence(c, pattern, true);
+        }
+        if (verbose) {
+            imu_rotation_t r;
+            imu_rotation_set_thresholds(&r, c->tilt_right, c->tilt_left, c->lsb);
+            printf("  counts: enter_normal %d, enter_flipped %d, axis_margin %d\n",
+                   r.enter_normal, r.enter_flipped, r.axis_margin);
+        }
+    }
+    printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? 1 : 0;
+}
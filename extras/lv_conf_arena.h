@@ -0,0 +1,49 @@
+/**
+ * LVGL fixed arena configuration snippet (zero heap after init)
+ *
+ * LVGL uses its built-in TLSF allocator on one pool that is taken from the
+ * system heap exactly once, in lv_init(). Every LVGL object, style and label
+ * text of the HomeWind screens then lives in that pool; after homewind_init()
+ * the UI update path makes no heap calls, so long sessions cannot fragment
+ * the system heap. Pair with HOMEWIND_ZERO_HEAP 1 in lcd_config.h to get
+ * stray allocations reported (see homewind_set_alloc_hook()).
+ *
+ * How to use (choose one):
+ *
+ * 1) Include from your project's lv_conf.h (before any other LV_MEM_* defines):
+ *    #include "extras/lv_conf_arena.h"
+ *    (Adjust path if your lv_conf.h is not at project root.)
+ *
+ * 2) Copy the defines below into your lv_conf.h.
+ *
+ * Do not combine with lv_conf_psram.h; put the arena in PSRAM with
+ * HOMEWIND_LVGL_ARENA_CAPS instead.
+ *
+ * Sizing: check lv_mem_monitor() (max_used, frag_pct) after a long session
+ * with all screens and the settings modal opened, and leave some headroom.
+ * If the arena runs out LVGL returns NULL and LV_ASSERT_MALLOC fires.
+ *
+ * HomeWindWSAmoled – optional extra
+ */
+
+#ifndef LV_CONF_ARENA_H
+#define LV_CONF_ARENA_H
+
+#ifdef LV_CONF_PSRAM_H
+#error "lv_conf_arena.h and lv_conf_psram.h are exclusive; use HOMEWIND_LVGL_ARENA_CAPS for a PSRAM arena"
+#endif
+
+#ifndef HOMEWIND_LVGL_ARENA_SIZE
+#define HOMEWIND_LVGL_ARENA_SIZE    (96U * 1024U)
+#endif
+#ifndef HOMEWIND_LVGL_ARENA_CAPS
+#define HOMEWIND_LVGL_ARENA_CAPS    (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+
+#define LV_MEM_CUSTOM 0
+#define LV_MEM_SIZE HOMEWIND_LVGL_ARENA_SIZE
+#define LV_MEM_ADR 0
+#define LV_MEM_POOL_INCLUDE "esp_heap_caps.h"
+#define LV_MEM_POOL_ALLOC(size)     heap_caps_malloc(size, HOMEWIND_LVGL_ARENA_CAPS)
+
+#endif /* LV_CONF_ARENA_H */
@@ -1,6 +1,7 @@
 #include "FT3168.h"
 #include "esp_err.h"
 #include "lcd_config.h"
+#include "perf_stats.h"
 #include <string.h>  // For memcpy
 
 #define TEST_I2C_PORT I2C_NUM_0
@@ -28,13 +29,21 @@ uint8_t I2C_writr_buff(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len)
     memcpy(&stack_buf[1], buf, len);
   }
   
-  ret = i2c_master_write_to_device(TEST_I2C_PORT, addr, stack_buf, len + 1, 1000);
+  esp_err_t err = i2c_master_write_to_device(TEST_I2C_PORT, addr, stack_buf, len + 1, 1000);
+  if (err != ESP_OK) {
+    perf_stats_i2c_error();
+  }
+  ret = err;
   return ret;
 }
 uint8_t I2C_read_buff(uint8_t addr,uint8_t reg,uint8_t *buf,uint8_t len)
 {
   uint8_t ret;
-  ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,&reg,1,buf,len,1000);
+  esp_err_t err = i2c_master_write_read_device(TEST_I2C_PORT,addr,&reg,1,buf,len,1000);
+  if (err != ESP_OK) {
+    perf_stats_i2c_error();
+  }
+  ret = err;
   return ret;
 }
 // REMOVED: I2C_master_write_read_device() - was never used in codebase
@@ -42,6 +42,13 @@
 #include "FT3168.h"
 #include "homewind_ui.h"
 #include "powersave.h"
+#include "history.h"
+#include "sensor_filter.h"
+#include "init_profile.h"
+#include "heap_guard.h"
+#include "mem_stats.h"
+#include "perf_stats.h"
+#include "event_trace.h"
 
 // Library version information
 #define HOMEWIND_WS_AMOLED_VERSION_MAJOR 1
@@ -80,6 +87,30 @@ extern "C" {
  */
 void homewind_init(void);
 
+/**
+ * @brief Initialize the library with a selectable init mode
+ * 
+ * - HOMEWIND_INIT_SEQUENTIAL: same as homewind_init()
+ * - HOMEWIND_INIT_PARALLEL: the panel reset/init sequence runs on esp_timer
+ *   (non-blocking) and the IMU probe on a helper task while LVGL and the
+ *   screens are created. The function returns without waiting for the panel;
+ *   the first frame is flushed the moment the panel is ready. Time-to-first-
+ *   frame becomes max(panel, UI) instead of the sum.
+ * 
+ * Per-phase timing is available afterwards via homewind_get_init_timing().
+ * 
+ * @code
+ * homewind_init_ex(HOMEWIND_INIT_PARALLEL);
+ * const homewind_init_timing_t *t = homewind_get_init_timing();
+ * for (int i = 0; i < HOMEWIND_INIT_PHASE_COUNT; i++) {
+ *   if (!t->phases[i].ran) continue;
+ *   Serial.printf("%-12s %6lu us\n", homewind_init_phase_name((homewind_init_phase_t)i),
+ *                 (unsigned long)t->phases[i].duration_us);
+ * }
+ * @endcode
+ */
+void homewind_init_ex(homewind_init_mode_t mode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -98,6 +129,8 @@ void homewind_init(void);
  * 
  * @note Automatic rotation based on IMU sensor is enabled automatically
  *       if QMI8658 hardware is detected. No additional code needed!
+ * @note 90°/270° switch the main screen to its landscape layout (cached,
+ *       no screen rebuild).
  * 
  * @example
  * @code
@@ -147,5 +180,66 @@ void homewind_init(void);
  */
 #define homewind_get_imu_tilt_thresholds(tilt_right, tilt_left) lcd_get_imu_tilt_thresholds(tilt_right, tilt_left)
 
+/**
+ * @brief Let automatic rotation also use 90°/270° (landscape)
+ * 
+ * Off by default: the IMU only flips between 0° and 180°. When enabled,
+ * landscape is chosen once the accelerometer Y axis clearly leads X
+ * (handlebar mounting); 90° vs 270° uses the tilt thresholds on Y.
+ * 
+ * @note Only works if QMI8658 IMU hardware is present
+ */
+#define homewind_set_imu_four_way(enable) lcd_set_imu_four_way(enable)
+
+/**
+ * @brief Read the fused tilt angles (IMU gravity vector)
+ * 
+ * @param pitch_deg10 Rotation about Y in 0.1° (-900..900), can be NULL
+ * @param roll_deg10 Rotation about X in 0.1° (-1800..1800), can be NULL
+ * @return false until the IMU task delivered its first batch
+ * 
+ * @note Only works if QMI8658 IMU hardware is present
+ */
+#define homewind_get_imu_tilt(pitch_deg10, roll_deg10) lcd_get_imu_tilt(pitch_deg10, roll_deg10)
+
+/**
+ * @brief Register a callback for the IMU bring-up result
+ * 
+ * homewind_init() only starts the IMU task; probing, calibration (~2.3 s) and
+ * the optional self-test run there. The callback runs once in the IMU task
+ * with LCD_IMU_STATUS_READY, _NOT_FOUND or _SELFTEST_FAILED.
+ * 
+ * @param cb Callback or NULL
+ */
+#define homewind_set_imu_status_callback(cb) lcd_set_imu_status_callback(cb)
+
+/**
+ * @brief Current IMU bring-up state (lcd_imu_status_t)
+ */
+#define homewind_get_imu_status() lcd_get_imu_status()
+
+/**
+ * @brief Register a callback for "panel ready" (end of the SH8601 init sequence)
+ * 
+ * Mostly useful with homewind_init_ex(HOMEWIND_INIT_PARALLEL), where the panel
+ * finishes powering up after homewind_init_ex() returned. Runs in the esp_timer
+ * task; keep it short. Register before calling homewind_init_ex().
+ * 
+ * @param cb void cb(esp_err_t result)
+ */
+#define homewind_set_panel_ready_callback(cb) lcd_set_panel_ready_callback(cb)
+
+/**
+ * @brief Stack high-water mark of a library task
+ * 
+ * @param task LCD_TASK_LVGL or LCD_TASK_IMU
+ * @param info Filled with stack size and least free stack seen (bytes)
+ * @return false if the task was never started
+ * 
+ * @note Set LCD_STATIC_ALLOC 1 in lcd_config.h to place the task stacks,
+ *       TCBs, the LVGL mutex and the panel-ready semaphore in static RAM
+ */
+#define homewind_get_task_stack_info(task, info) lcd_get_task_stack_info(task, info)
+
 #endif // HOMEWIND_WS_AMOLED_H
 
@@ -16,6 +16,7 @@
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_commands.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "esp_lcd_sh8601.h"
 
@@ -34,6 +35,7 @@ static esp_err_t panel_sh8601_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool
 static esp_err_t panel_sh8601_swap_xy(esp_lcd_panel_t *panel, bool swap_axes);
 static esp_err_t panel_sh8601_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap);
 static esp_err_t panel_sh8601_disp_on_off(esp_lcd_panel_t *panel, bool off);
+static esp_err_t panel_sh8601_disp_sleep(esp_lcd_panel_t *panel, bool sleep);
 
 typedef struct {
     esp_lcd_panel_t base;
@@ -50,6 +52,15 @@ typedef struct {
         unsigned int use_qspi_interface: 1;
         unsigned int reset_level: 1;
     } flags;
+    struct {
+        esp_timer_handle_t timer;       /* One-shot timer driving the next step */
+        uint8_t step;                   /* sh8601_async_step_t */
+        uint16_t cmd_index;             /* Next entry of init_cmds */
+        bool disp_on;                   /* Send DISPON after the init commands */
+        bool busy;
+        sh8601_init_done_cb_t done_cb;
+        void *user_ctx;
+    } async;
 } sh8601_panel_t;
 
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -120,6 +131,7 @@ esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp
     sh8601->base.mirror = panel_sh8601_mirror;
     sh8601->base.swap_xy = panel_sh8601_swap_xy;
     sh8601->base.disp_on_off = panel_sh8601_disp_on_off;
+    sh8601->base.disp_sleep = panel_sh8601_disp_sleep;
     *ret_panel = &(sh8601->base);
     ESP_LOGD(TAG, "new sh8601 panel @%p", sh8601);
 
@@ -162,6 +174,10 @@ static esp_err_t panel_sh8601_del(esp_lcd_panel_t *panel)
 {
     sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
 
+    if (sh8601->async.timer) {
+        esp_timer_stop(sh8601->async.timer);
+        esp_timer_delete(sh8601->async.timer);
+    }
     if (sh8601->reset_gpio_num >= 0) {
         gpio_reset_pin(sh8601->reset_gpio_num);
     }
@@ -196,13 +212,22 @@ static const sh8601_lcd_init_cmd_t vendor_specific_init_default[] = {
     {0x53, (uint8_t []){0x20}, 1, 25},
 };
 
-static esp_err_t panel_sh8601_init(esp_lcd_panel_t *panel)
+static void sh8601_get_init_cmds(sh8601_panel_t *sh8601, const sh8601_lcd_init_cmd_t **cmds, uint16_t *size)
+{
+    // vendor specific initialization, it can be different between manufacturers
+    // should consult the LCD supplier for initialization sequence code
+    if (sh8601->init_cmds) {
+        *cmds = sh8601->init_cmds;
+        *size = sh8601->init_cmds_size;
+    } else {
+        *cmds = vendor_specific_init_default;
+        *size = sizeof(vendor_specific_init_default) / sizeof(sh8601_lcd_init_cmd_t);
+    }
+}
+
+static esp_err_t sh8601_send_config(sh8601_panel_t *sh8601)
 {
-    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
     esp_lcd_panel_io_handle_t io = sh8601->io;
-    const sh8601_lcd_init_cmd_t *init_cmds = NULL;
-    uint16_t init_cmds_size = 0;
-    bool is_cmd_overwritten = false;
 
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_MADCTL, (uint8_t[]) {
         sh8601->madctl_val,
@@ -210,44 +235,183 @@ static esp_err_t panel_sh8601_init(esp_lcd_panel_t *panel)
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_COLMOD, (uint8_t[]) {
         sh8601->colmod_val,
     }, 1), TAG, "send command failed");
+    return ESP_OK;
+}
 
-    // vendor specific initialization, it can be different between manufacturers
-    // should consult the LCD supplier for initialization sequence code
-    if (sh8601->init_cmds) {
-        init_cmds = sh8601->init_cmds;
-        init_cmds_size = sh8601->init_cmds_size;
-    } else {
-        init_cmds = vendor_specific_init_default;
-        init_cmds_size = sizeof(vendor_specific_init_default) / sizeof(sh8601_lcd_init_cmd_t);
+static esp_err_t sh8601_send_init_cmd(sh8601_panel_t *sh8601, const sh8601_lcd_init_cmd_t *init_cmd)
+{
+    bool is_cmd_overwritten = false;
+
+    // Check if the command has been used or conflicts with the internal
+    switch (init_cmd->cmd) {
+    case LCD_CMD_MADCTL:
+        is_cmd_overwritten = true;
+        sh8601->madctl_val = ((uint8_t *)init_cmd->data)[0];
+        break;
+    case LCD_CMD_COLMOD:
+        is_cmd_overwritten = true;
+        sh8601->colmod_val = ((uint8_t *)init_cmd->data)[0];
+        break;
+    default:
+        is_cmd_overwritten = false;
+        break;
     }
 
+    if (is_cmd_overwritten) {
+        ESP_LOGW(TAG, "The %02Xh command has been used and will be overwritten by external initialization sequence", init_cmd->cmd);
+    }
+
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, sh8601->io, init_cmd->cmd, init_cmd->data, init_cmd->data_bytes), TAG,
+                        "send command failed");
+    return ESP_OK;
+}
+
+static esp_err_t panel_sh8601_init(esp_lcd_panel_t *panel)
+{
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    const sh8601_lcd_init_cmd_t *init_cmds = NULL;
+    uint16_t init_cmds_size = 0;
+
+    ESP_RETURN_ON_ERROR(sh8601_send_config(sh8601), TAG, "send config failed");
+
+    sh8601_get_init_cmds(sh8601, &init_cmds, &init_cmds_size);
     for (int i = 0; i < init_cmds_size; i++) {
-        // Check if the command has been used or conflicts with the internal
-        switch (init_cmds[i].cmd) {
-        case LCD_CMD_MADCTL:
-            is_cmd_overwritten = true;
-            sh8601->madctl_val = ((uint8_t *)init_cmds[i].data)[0];
+        ESP_RETURN_ON_ERROR(sh8601_send_init_cmd(sh8601, &init_cmds[i]), TAG, "send init command failed");
+        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+    }
+    ESP_LOGD(TAG, "send init commands success");
+
+    return ESP_OK;
+}
+
+/* --- Non-blocking reset + init (esp_timer state machine) ---
+ * Same sequence as panel_sh8601_reset() + panel_sh8601_init() (+ DISPON),
+ * but every delay is a one-shot esp_timer instead of vTaskDelay. Commands are
+ * sent from the esp_timer task; consecutive commands without delay are sent
+ * in one step. */
+typedef enum {
+    SH8601_ASYNC_RESET_RELEASE = 0,  /* Reset pulse done, release the line */
+    SH8601_ASYNC_CONFIG,             /* Reset settled: MADCTL/COLMOD */
+    SH8601_ASYNC_CMDS,               /* Vendor init commands */
+    SH8601_ASYNC_DISP_ON,
+    SH8601_ASYNC_DONE,
+} sh8601_async_step_t;
+
+static void sh8601_async_finish(sh8601_panel_t *sh8601, esp_err_t result)
+{
+    sh8601->async.busy = false;
+    if (result == ESP_OK) {
+        ESP_LOGD(TAG, "async init done");
+    } else {
+        ESP_LOGE(TAG, "async init failed at step %d (%d)", sh8601->async.step, result);
+    }
+    if (sh8601->async.done_cb) {
+        sh8601->async.done_cb(&sh8601->base, result, sh8601->async.user_ctx);
+    }
+}
+
+static void sh8601_async_timer_cb(void *arg)
+{
+    sh8601_panel_t *sh8601 = (sh8601_panel_t *)arg;
+    const sh8601_lcd_init_cmd_t *init_cmds = NULL;
+    uint16_t init_cmds_size = 0;
+    uint32_t delay_ms = 0;
+    esp_err_t ret = ESP_OK;
+
+    sh8601_get_init_cmds(sh8601, &init_cmds, &init_cmds_size);
+
+    while (delay_ms == 0 && sh8601->async.step != SH8601_ASYNC_DONE) {
+        switch (sh8601->async.step) {
+        case SH8601_ASYNC_RESET_RELEASE:
+            gpio_set_level(sh8601->reset_gpio_num, !sh8601->flags.reset_level);
+            delay_ms = 150;
+            sh8601->async.step = SH8601_ASYNC_CONFIG;
             break;
-        case LCD_CMD_COLMOD:
-            is_cmd_overwritten = true;
-            sh8601->colmod_val = ((uint8_t *)init_cmds[i].data)[0];
+        case SH8601_ASYNC_CONFIG:
+            ret = sh8601_send_config(sh8601);
+            sh8601->async.cmd_index = 0;
+            sh8601->async.step = SH8601_ASYNC_CMDS;
+            break;
+        case SH8601_ASYNC_CMDS:
+            if (sh8601->async.cmd_index >= init_cmds_size) {
+                sh8601->async.step = SH8601_ASYNC_DISP_ON;
+                break;
+            }
+            ret = sh8601_send_init_cmd(sh8601, &init_cmds[sh8601->async.cmd_index]);
+            delay_ms = init_cmds[sh8601->async.cmd_index].delay_ms;
+            sh8601->async.cmd_index++;
+            break;
+        case SH8601_ASYNC_DISP_ON:
+            if (sh8601->async.disp_on) {
+                ret = tx_param(sh8601, sh8601->io, LCD_CMD_DISPON, NULL, 0);
+            }
+            sh8601->async.step = SH8601_ASYNC_DONE;
             break;
         default:
-            is_cmd_overwritten = false;
+            sh8601->async.step = SH8601_ASYNC_DONE;
             break;
         }
-
-        if (is_cmd_overwritten) {
-            ESP_LOGW(TAG, "The %02Xh command has been used and will be overwritten by external initialization sequence", init_cmds[i].cmd);
+        if (ret != ESP_OK) {
+            sh8601_async_finish(sh8601, ret);
+            return;
         }
+    }
 
-        ESP_RETURN_ON_ERROR(tx_param(sh8601, io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes), TAG,
-                            "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+    if (sh8601->async.step == SH8601_ASYNC_DONE) {
+        ESP_LOGD(TAG, "send init commands success");
+        sh8601_async_finish(sh8601, ESP_OK);
+        return;
     }
-    ESP_LOGD(TAG, "send init commands success");
+    ret = esp_timer_start_once(sh8601->async.timer, (uint64_t)delay_ms * 1000);
+    if (ret != ESP_OK) {
+        sh8601_async_finish(sh8601, ret);
+    }
+}
 
-    return ESP_OK;
+esp_err_t esp_lcd_sh8601_init_async(esp_lcd_panel_handle_t panel, bool disp_on,
+                                    sh8601_init_done_cb_t done_cb, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    ESP_RETURN_ON_FALSE(!sh8601->async.busy, ESP_ERR_INVALID_STATE, TAG, "async init already running");
+
+    if (!sh8601->async.timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = sh8601_async_timer_cb,
+            .arg = sh8601,
+            .name = "sh8601_init",
+        };
+        ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &sh8601->async.timer), TAG, "create timer failed");
+    }
+
+    sh8601->async.done_cb = done_cb;
+    sh8601->async.user_ctx = user_ctx;
+    sh8601->async.disp_on = disp_on;
+    sh8601->async.cmd_index = 0;
+    sh8601->async.busy = true;
+
+    // First step runs here; the remaining ones on the timer
+    uint32_t delay_ms;
+    if (sh8601->reset_gpio_num >= 0) {
+        gpio_set_level(sh8601->reset_gpio_num, sh8601->flags.reset_level);
+        sh8601->async.step = SH8601_ASYNC_RESET_RELEASE;
+        delay_ms = 10;
+    } else { // software reset
+        esp_err_t ret = tx_param(sh8601, sh8601->io, LCD_CMD_SWRESET, NULL, 0);
+        if (ret != ESP_OK) {
+            sh8601->async.busy = false;
+            ESP_LOGE(TAG, "send command failed");
+            return ret;
+        }
+        sh8601->async.step = SH8601_ASYNC_CONFIG;
+        delay_ms = 80;
+    }
+
+    esp_err_t ret = esp_timer_start_once(sh8601->async.timer, (uint64_t)delay_ms * 1000);
+    if (ret != ESP_OK) {
+        sh8601->async.busy = false;
+    }
+    return ret;
 }
 
 static esp_err_t panel_sh8601_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
@@ -344,3 +508,13 @@ static esp_err_t panel_sh8601_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
+
+static esp_err_t panel_sh8601_disp_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    esp_lcd_panel_io_handle_t io = sh8601->io;
+    /* Caller waits 120 ms after sleep-out before the next command */
+    int command = sleep ? LCD_CMD_SLPIN : LCD_CMD_SLPOUT;
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "esp_lcd_panel_vendor.h"
 
@@ -55,6 +56,38 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Completion callback of esp_lcd_sh8601_init_async()
+ *
+ * @note Called from the esp_timer task; keep it short.
+ *
+ * @param[in] panel    LCD panel handle
+ * @param[in] result   ESP_OK on success, error of the failing command otherwise
+ * @param[in] user_ctx User context passed to esp_lcd_sh8601_init_async()
+ */
+typedef void (*sh8601_init_done_cb_t)(esp_lcd_panel_handle_t panel, esp_err_t result, void *user_ctx);
+
+/**
+ * @brief Reset and initialize the panel without blocking
+ *
+ * Runs the same sequence as `esp_lcd_panel_reset()` + `esp_lcd_panel_init()` (and optionally
+ * `esp_lcd_panel_disp_on_off(panel, true)`), but the reset pulse, sleep-out and per-command
+ * delays are driven by a one-shot esp_timer. The function returns right after the first step.
+ *
+ * @note Do not send other commands or pixel data to the panel until `done_cb` reports ESP_OK.
+ *
+ * @param[in] panel    LCD panel handle created by `esp_lcd_new_panel_sh8601()`
+ * @param[in] disp_on  Send DISPON after the init commands
+ * @param[in] done_cb  Completion callback (can be NULL)
+ * @param[in] user_ctx User context for `done_cb`
+ * @return
+ *      - ESP_OK: Sequence started
+ *      - ESP_ERR_INVALID_STATE: An async init is already running
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_init_async(esp_lcd_panel_handle_t panel, bool disp_on,
+                                    sh8601_init_done_cb_t done_cb, void *user_ctx);
+
 /**
  * @brief LCD panel bus configuration structure
  *
@@ -0,0 +1,182 @@
+// event_trace.c
+#include "event_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+#if HOMEWIND_EVENT_TRACE
+
+#define TRACE_MIN_RECORDS   16
+#define TRACE_MAX_THREADS   8                       /* Rows: 0 = ISR, 1..6 = tasks, 7 = any further task */
+#define TRACE_TID_OTHER     (TRACE_MAX_THREADS - 1)
+#define TRACE_NAME_LEN      16
+
+static const char *const event_names[HOMEWIND_TRACE_EVENT_COUNT] = {
+    "lvgl",
+    "ui_apply",
+    "flush",
+    "dma_done",
+    "touch",
+    "imu_read",
+    "setter",
+    "power",
+};
+
+static homewind_trace_record_t *trace_ring = NULL;
+static uint32_t trace_cap = 0;
+static _Atomic uint32_t trace_head = 0;
+static _Atomic bool trace_on = false;
+
+/* --- Thread rows (claimed by the first record a task makes) --- */
+static _Atomic(TaskHandle_t) thread_task[TRACE_MAX_THREADS];
+static char thread_name[TRACE_MAX_THREADS][TRACE_NAME_LEN];
+
+static uint8_t IRAM_ATTR trace_tid(void)
+{
+    if (xPortInIsrContext()) return 0;
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (uint8_t i = 1; i < TRACE_TID_OTHER; i++) {
+        TaskHandle_t task = atomic_load_explicit(&thread_task[i], memory_order_acquire);
+        if (task == self) return i;
+        if (task == NULL) {
+            TaskHandle_t expected = NULL;
+            if (atomic_compare_exchange_strong(&thread_task[i], &expected, self)) {
+                strncpy(thread_name[i], pcTaskGetName(self), TRACE_NAME_LEN - 1);
+                return i;
+            }
+        }
+    }
+    return TRACE_TID_OTHER;
+}
+
+/* ============================================================================
+ * Recording (any task, ISR)
+ * ============================================================================ */
+
+void IRAM_ATTR event_trace_record(homewind_trace_event_t event, char phase, uint32_t arg)
+{
+    if (!atomic_load_explicit(&trace_on, memory_order_acquire)) return;
+
+    uint32_t idx = atomic_fetch_add_explicit(&trace_head, 1, memory_order_relaxed);
+    homewind_trace_record_t *rec = &trace_ring[idx % trace_cap];
+    rec->ts_us = (uint32_t)esp_timer_get_time();
+    rec->arg = arg;
+    rec->event = (uint8_t)event;
+    rec->phase = (uint8_t)phase;
+    rec->tid = trace_tid();
+    rec->reserved = 0;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool homewind_trace_start(void *buf, size_t size)
+{
+    uint32_t cap = (uint32_t)(size / sizeof(homewind_trace_record_t));
+    if (!buf || cap < TRACE_MIN_RECORDS) return false;
+
+    atomic_store_explicit(&trace_on, false, memory_order_release);
+    trace_ring = (homewind_trace_record_t *)buf;
+    trace_cap = cap;
+    atomic_store_explicit(&trace_head, 0, memory_order_relaxed);
+    for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+        atomic_store_explicit(&thread_task[i], NULL, memory_order_relaxed);
+        thread_name[i][0] = '\0';
+    }
+    atomic_store_explicit(&trace_on, true, memory_order_release);
+    return true;
+}
+
+void homewind_trace_stop(void)
+{
+    atomic_store_explicit(&trace_on, false, memory_order_release);
+}
+
+uint32_t homewind_trace_count(void)
+{
+    uint32_t head = atomic_load_explicit(&trace_head, memory_order_relaxed);
+    return head < trace_cap ? head : trace_cap;
+}
+
+static void trace_write(homewind_trace_write_t write, void *ctx, const char *text, int len)
+{
+    if (len > 0) write(text, (size_t)len, ctx);
+}
+
+uint32_t homewind_trace_dump(homewind_trace_write_t write, void *ctx)
+{
+    if (!write || !trace_ring) return 0;
+
+    uint32_t count = homewind_trace_count();
+    uint32_t first = atomic_load_explicit(&trace_head, memory_order_relaxed) - count;
+    char line[192];
+    int len;
+
+    /* Slots are reserved before the timestamp is taken, so the oldest slot
+     * is not always the earliest time; the viewers sort by ts anyway */
+    uint32_t base = count ? trace_ring[first % trace_cap].ts_us : 0;
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t ts = trace_ring[(first + i) % trace_cap].ts_us;
+        if ((int32_t)(ts - base) < 0) base = ts;
+    }
+
+    len = snprintf(line, sizeof(line),
+                   "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                   "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"HomeWind\"}}");
+    trace_write(write, ctx, line, len);
+    for (int tid = 0; tid < TRACE_MAX_THREADS; tid++) {
+        const char *name = tid == 0 ? "ISR" : tid == TRACE_TID_OTHER ? "other" : thread_name[tid];
+        if (!name[0]) continue;
+        len = snprintf(line, sizeof(line),
+                       ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                       tid, name);
+        trace_write(write, ctx, line, len);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const homewind_trace_record_t *rec = &trace_ring[(first + i) % trace_cap];
+        const char *name = rec->event < HOMEWIND_TRACE_EVENT_COUNT ? event_names[rec->event] : "?";
+        len = snprintf(line, sizeof(line),
+                       ",\n{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%lu,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%lu}}",
+                       name, rec->phase, rec->phase == 'i' ? "\"s\":\"t\"," : "",
+                       (unsigned long)(rec->ts_us - base), rec->tid, (unsigned long)rec->arg);
+        trace_write(write, ctx, line, len);
+    }
+
+    len = snprintf(line, sizeof(line), "\n]}\n");
+    trace_write(write, ctx, line, len);
+    return count;
+}
+
+#else /* !HOMEWIND_EVENT_TRACE */
+
+bool homewind_trace_start(void *buf, size_t size)
+{
+    (void)buf;
+    (void)size;
+    return false;
+}
+
+void homewind_trace_stop(void)
+{
+}
+
+uint32_t homewind_trace_count(void)
+{
+    return 0;
+}
+
+uint32_t homewind_trace_dump(homewind_trace_write_t write, void *ctx)
+{
+    (void)write;
+    (void)ctx;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lcd_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Event Trace (HOMEWIND_EVENT_TRACE)
+ * ============================================================================
+ * Timeline of what the LVGL task, the IMU task, the flush ISR and the app
+ * tasks do, for chrome://tracing or ui.perfetto.dev. Begin/end and instant
+ * records go into a ring in a caller-supplied buffer (oldest overwritten);
+ * homewind_trace_dump() writes them as Chrome trace JSON, one thread row per
+ * task. Writers reserve a slot with one atomic add, so any task and the ISR
+ * can record; while no trace runs a hook costs a call and one load.
+ * ============================================================================ */
+
+typedef enum {
+    HOMEWIND_TRACE_LVGL = 0,    /* LVGL pass: frame hook + lv_timer_handler() (span) */
+    HOMEWIND_TRACE_UI_APPLY,    /* Setter mailbox applied to the widgets (span, arg = dirty bits) */
+    HOMEWIND_TRACE_FLUSH,       /* flush_cb queueing one area (span, arg = bytes) */
+    HOMEWIND_TRACE_DMA_DONE,    /* Flush DMA finished (instant, ISR) */
+    HOMEWIND_TRACE_TOUCH,       /* FT3168 read (span, arg = pressed) */
+    HOMEWIND_TRACE_IMU_READ,    /* QMI8658 FIFO batch read (span, arg = samples) */
+    HOMEWIND_TRACE_SETTER,      /* homewind_set_* call (instant, arg = dirty bits raised) */
+    HOMEWIND_TRACE_POWER,       /* Power state change (instant, arg = ui_power_state_t) */
+    HOMEWIND_TRACE_EVENT_COUNT
+} homewind_trace_event_t;
+
+typedef struct {
+    uint32_t ts_us;             /* esp_timer_get_time(), low 32 bits */
+    uint32_t arg;
+    uint8_t event;              /* homewind_trace_event_t */
+    uint8_t phase;              /* 'B', 'E' or 'i' (Chrome trace phases) */
+    uint8_t tid;                /* Thread row, 0 = ISR */
+    uint8_t reserved;
+} homewind_trace_record_t;      /* 12 bytes */
+
+/** Receives the JSON text in pieces (e.g. Serial.write) */
+typedef void (*homewind_trace_write_t)(const char *data, size_t len, void *ctx);
+
+/**
+ * @brief Start recording into buf (internal RAM or PSRAM); restarts a running trace
+ * @return false if buf cannot hold at least 16 records or the library was built
+ *         with HOMEWIND_EVENT_TRACE 0
+ */
+bool homewind_trace_start(void *buf, size_t size);
+
+/** @brief Stop recording; the buffer keeps the records for homewind_trace_dump() */
+void homewind_trace_stop(void);
+
+/** @brief Records in the ring (at most its capacity) */
+uint32_t homewind_trace_count(void);
+
+/**
+ * @brief Write the ring as Chrome trace JSON (call after homewind_trace_stop())
+ * @return Records written
+ */
+uint32_t homewind_trace_dump(homewind_trace_write_t write, void *ctx);
+
+/* --- Internal (library hot paths) --- */
+#if HOMEWIND_EVENT_TRACE
+void event_trace_record(homewind_trace_event_t event, char phase, uint32_t arg);
+static inline void event_trace_begin(homewind_trace_event_t event, uint32_t arg) { event_trace_record(event, 'B', arg); }
+static inline void event_trace_end(homewind_trace_event_t event, uint32_t arg) { event_trace_record(event, 'E', arg); }
+static inline void event_trace_instant(homewind_trace_event_t event, uint32_t arg) { event_trace_record(event, 'i', arg); }
+#else
+static inline void event_trace_begin(homewind_trace_event_t event, uint32_t arg) { (void)event; (void)arg; }
+static inline void event_trace_end(homewind_trace_event_t event, uint32_t arg) { (void)event; (void)arg; }
+static inline void event_trace_instant(homewind_trace_event_t event, uint32_t arg) { (void)event; (void)arg; }
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,146 @@
+// heap_guard.c
+#include "heap_guard.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "lv_conf_psram_auto.h"
+#include "lvgl.h"
+#include <stdatomic.h>
+
+static homewind_alloc_hook_t alloc_hook = NULL;
+
+#if HOMEWIND_ZERO_HEAP
+
+#if LV_MEM_CUSTOM
+#warning "HOMEWIND_ZERO_HEAP: LVGL allocates from the system heap (LV_MEM_CUSTOM 1); include extras/lv_conf_arena.h from lv_conf.h"
+#endif
+
+#if defined(CONFIG_HEAP_USE_HOOKS) && CONFIG_HEAP_USE_HOOKS
+#define HEAP_GUARD_HOOKS 1
+#else
+#define HEAP_GUARD_HOOKS 0
+#endif
+
+#define HEAP_GUARD_MAX_TASKS    4
+
+static const char *TAG = "heap_guard";
+
+/* --- Watched tasks (library tasks register themselves) --- */
+static TaskHandle_t watched[HEAP_GUARD_MAX_TASKS];
+static _Atomic uint8_t watched_count = 0;
+static volatile bool sealed = false;
+
+/* --- Stray calls (heap hooks, any task) ---
+ * Only the count is exact; two library tasks hitting the heap at the same
+ * moment can mix up the last_* fields, which are diagnostics only. */
+static _Atomic uint32_t stray_count = 0;
+static volatile size_t last_size = 0;
+static volatile uint32_t last_caps = 0;
+static TaskHandle_t volatile last_task = NULL;
+
+/* --- Reporting (LVGL task) --- */
+static uint32_t reported_count = 0;
+static TaskHandle_t volatile reporting_task = NULL;  /* Heap calls of the report itself are not counted */
+
+void heap_guard_watch_current_task(void)
+{
+    uint8_t n = atomic_fetch_add_explicit(&watched_count, 1, memory_order_relaxed);
+    if (n < HEAP_GUARD_MAX_TASKS) watched[n] = xTaskGetCurrentTaskHandle();
+}
+
+void heap_guard_seal(void)
+{
+    sealed = true;
+}
+
+#if HEAP_GUARD_HOOKS
+static void IRAM_ATTR heap_guard_record(size_t size, uint32_t caps)
+{
+    if (!sealed || xPortInIsrContext()) return;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (task == reporting_task) return;
+
+    uint8_t n = atomic_load_explicit(&watched_count, memory_order_relaxed);
+    if (n > HEAP_GUARD_MAX_TASKS) n = HEAP_GUARD_MAX_TASKS;
+    for (uint8_t i = 0; i < n; i++) {
+        if (watched[i] == task) {
+            last_size = size;
+            last_caps = caps;
+            last_task = task;
+            atomic_fetch_add_explicit(&stray_count, 1, memory_order_release);
+            return;
+        }
+    }
+}
+
+/* ESP-IDF heap hooks (weak in the heap component, CONFIG_HEAP_USE_HOOKS) */
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    (void)ptr;
+    heap_guard_record(size, caps);
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+    if (ptr) heap_guard_record(0, 0);
+}
+#endif
+
+void heap_guard_poll(void)
+{
+    uint32_t count = atomic_load_explicit(&stray_count, memory_order_acquire);
+    if (count == reported_count) return;
+    reported_count = count;
+
+    TaskHandle_t task = last_task;
+    homewind_stray_alloc_t info = {
+        .size = last_size,
+        .caps = last_caps,
+        .task = task ? pcTaskGetName(task) : "?",
+        .count = count,
+    };
+    reporting_task = xTaskGetCurrentTaskHandle();
+    if (alloc_hook) {
+        alloc_hook(&info);
+    } else {
+        ESP_LOGE(TAG, "stray heap %s: %u bytes (caps 0x%lx) in %s, %lu since init",
+                 info.size ? "alloc" : "free", (unsigned)info.size, (unsigned long)info.caps,
+                 info.task, (unsigned long)info.count);
+    }
+    reporting_task = NULL;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+uint32_t homewind_get_stray_alloc_count(void)
+{
+    return atomic_load_explicit(&stray_count, memory_order_relaxed);
+}
+
+bool homewind_heap_guard_active(void)
+{
+    return HEAP_GUARD_HOOKS && sealed;
+}
+
+#else /* !HOMEWIND_ZERO_HEAP */
+
+uint32_t homewind_get_stray_alloc_count(void)
+{
+    return 0;
+}
+
+bool homewind_heap_guard_active(void)
+{
+    return false;
+}
+
+#endif
+
+void homewind_set_alloc_hook(homewind_alloc_hook_t hook)
+{
+    alloc_hook = hook;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lcd_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Zero-Heap-After-Init Guard (HOMEWIND_ZERO_HEAP)
+ * ============================================================================
+ * With extras/lv_conf_arena.h in lv_conf.h, LVGL takes one fixed pool at
+ * lv_init() and every object, style and label text of the library's screens
+ * lives there; the UI update path never touches the system heap. This guard
+ * checks that promise: after homewind_init() returns, any heap_caps_malloc /
+ * free made by a library task (LVGL, IMU) counts as a stray allocation and
+ * is reported from the LVGL task through homewind_set_alloc_hook().
+ *
+ * Detection uses the ESP-IDF heap hooks (CONFIG_HEAP_USE_HOOKS, IDF 5.1+);
+ * without them the arena still applies but homewind_heap_guard_active()
+ * returns false. Callbacks the library runs in the LVGL task (fan toggle,
+ * rotation, ...) are checked as well.
+ * ============================================================================ */
+
+typedef struct {
+    size_t size;        /* Requested bytes, 0 for a free */
+    uint32_t caps;      /* MALLOC_CAP_* of the request (0 for a free) */
+    const char *task;   /* Task that made the call */
+    uint32_t count;     /* Stray calls since init, including this one */
+} homewind_stray_alloc_t;
+
+/** Stray allocation report (LVGL task, outside the LVGL lock; heap calls in here are not counted) */
+typedef void (*homewind_alloc_hook_t)(const homewind_stray_alloc_t *info);
+
+/**
+ * @brief Register the stray allocation hook (NULL = log with ESP_LOGE)
+ * Several calls between two LVGL passes are reported once, with the latest call and the total count.
+ */
+void homewind_set_alloc_hook(homewind_alloc_hook_t hook);
+
+/** @brief Heap calls by library tasks since homewind_init() returned */
+uint32_t homewind_get_stray_alloc_count(void);
+
+/** @brief true once sealed in a HOMEWIND_ZERO_HEAP build with CONFIG_HEAP_USE_HOOKS */
+bool homewind_heap_guard_active(void);
+
+/* --- Internal (library) --- */
+#if HOMEWIND_ZERO_HEAP
+void heap_guard_watch_current_task(void);  /* Library task, once its own setup is done */
+void heap_guard_seal(void);                /* End of homewind_init() */
+void heap_guard_poll(void);                /* LVGL task, once per pass */
+#else
+static inline void heap_guard_watch_current_task(void) {}
+static inline void heap_guard_seal(void) {}
+static inline void heap_guard_poll(void) {}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,407 @@
+// history.c
+#include "history.h"
+#include "powersave.h"
+#include "lcd_bsp.h"
+#include "ui_colors.h"
+#include "ui_style_helpers.h"
+#include "mem_stats.h"
+#include <string.h>
+#include <stdio.h>
+
+LV_FONT_DECLARE(lv_font_inter_bold_14);
+LV_FONT_DECLARE(lv_font_inter_bold_24);
+
+/* --- Chart Geometry --- */
+#define CHART_W                 HOMEWIND_HISTORY_COLUMNS
+#define CHART_H                 80
+#define CHART_STRIDE            ((CHART_W + 7) / 8)          /* 1 bpp row */
+#define CHART_PALETTE_BYTES     (2 * sizeof(lv_color32_t))   /* Indexed 1-bit palette in front of the pixels */
+#define HISTORY_SUBSAMPLE_MS    250                          /* minutes sub-samples = one column */
+#define PANEL_ANIMATION_TIME_MS 300
+#define CARD_H                  150
+#define CARD_GAP                12
+#define CARD_PAD                16
+#define CARD_H_LANDSCAPE        136                          /* Two cards fit the 280 px height */
+#define CARD_GAP_LANDSCAPE      6
+#define CARD_PAD_LANDSCAPE      8
+#define CARD_W_LANDSCAPE        (CHART_W + 2 * CARD_PAD)
+#define BUTTON_H                72
+#define RADIUS_CARD             36
+#define RADIUS_BUTTON           36
+
+/* --- Series --- */
+typedef struct {
+    /* Ring of decimated samples, HOMEWIND_HISTORY_GAP = sensor not active */
+    uint8_t ring[HOMEWIND_HISTORY_COLUMNS];
+    uint16_t head;            /* Next write position (oldest sample) */
+    /* Current column bucket */
+    uint32_t bucket_sum;
+    uint16_t bucket_count;
+    /* Latest value from the model */
+    bool active;
+    uint16_t current;
+    /* Fixed vertical scale (keeps rendering incremental) */
+    uint16_t scale_min;
+    uint16_t scale_max;
+    lv_color_t color;
+    lv_obj_t *canvas;
+    uint8_t canvas_buf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(CHART_W, CHART_H)];
+} history_series_t;
+
+static history_series_t series[2] = {
+    [HOMEWIND_HISTORY_HR]      = { .scale_min = 40, .scale_max = 200 },
+    [HOMEWIND_HISTORY_CADENCE] = { .scale_min = 0,  .scale_max = 150 },
+};
+
+/* --- State --- */
+static lv_timer_t *history_timer = NULL;
+static uint8_t history_minutes = HOMEWIND_HISTORY_DEFAULT_MINUTES;
+static volatile uint8_t history_minutes_req = HOMEWIND_HISTORY_DEFAULT_MINUTES;
+static uint8_t subsample_ticks = 0;
+
+static lv_obj_t *history_panel = NULL;
+static lv_obj_t *lbl_window = NULL;
+static lv_obj_t *btn_close = NULL;
+static lv_obj_t *cards[2] = { NULL, NULL };
+static bool history_panel_visible = false;
+
+/* ============================================================================
+ * Ring Buffer + Incremental Chart
+ * ============================================================================ */
+
+static uint8_t *chart_pixels(history_series_t *s)
+{
+    return s->canvas_buf + CHART_PALETTE_BYTES;
+}
+
+static lv_coord_t chart_y(const history_series_t *s, uint8_t v)
+{
+    if (v <= s->scale_min) return CHART_H - 1;
+    if (v >= s->scale_max) return 0;
+    return (lv_coord_t)(CHART_H - 1 - ((uint32_t)(v - s->scale_min) * (CHART_H - 1)) / (s->scale_max - s->scale_min));
+}
+
+/* Scroll the whole bitmap one pixel to the left (MSB = leftmost pixel) */
+static void chart_shift_left(history_series_t *s)
+{
+    uint8_t *px = chart_pixels(s);
+    for (uint16_t y = 0; y < CHART_H; y++) {
+        uint8_t *row = px + y * CHART_STRIDE;
+        for (uint16_t i = 0; i < CHART_STRIDE - 1; i++) {
+            row[i] = (uint8_t)((row[i] << 1) | (row[i + 1] >> 7));
+        }
+        row[CHART_STRIDE - 1] = (uint8_t)(row[CHART_STRIDE - 1] << 1);
+    }
+}
+
+/* Draw the newest column (x = CHART_W - 1), joined to the previous sample */
+static void chart_draw_column(history_series_t *s, uint8_t prev, uint8_t sample)
+{
+    if (sample == HOMEWIND_HISTORY_GAP) return;
+    lv_coord_t y0 = chart_y(s, sample);
+    lv_coord_t y1 = (prev == HOMEWIND_HISTORY_GAP) ? y0 : chart_y(s, prev);
+    if (y1 < y0) { lv_coord_t t = y0; y0 = y1; y1 = t; }
+    if (y1 < CHART_H - 1) y1++;  /* 2 px minimum line height */
+
+    uint8_t *px = chart_pixels(s);
+    uint8_t bit = (uint8_t)(0x80 >> ((CHART_W - 1) & 7));
+    for (lv_coord_t y = y0; y <= y1; y++) {
+        px[y * CHART_STRIDE + (CHART_W - 1) / 8] |= bit;
+    }
+}
+
+static void series_push(history_series_t *s)
+{
+    uint8_t sample = HOMEWIND_HISTORY_GAP;
+    if (s->bucket_count) {
+        uint32_t avg = s->bucket_sum / s->bucket_count;
+        sample = (uint8_t)(avg > 254 ? 254 : avg);
+    }
+    s->bucket_sum = 0;
+    s->bucket_count = 0;
+
+    uint8_t prev = s->ring[(s->head + HOMEWIND_HISTORY_COLUMNS - 1) % HOMEWIND_HISTORY_COLUMNS];
+    s->ring[s->head] = sample;
+    s->head = (s->head + 1) % HOMEWIND_HISTORY_COLUMNS;
+
+    chart_shift_left(s);
+    chart_draw_column(s, prev, sample);
+    if (history_panel_visible && s->canvas) {
+        lv_obj_invalidate(s->canvas);
+    }
+}
+
+static void series_reset(history_series_t *s)
+{
+    memset(s->ring, HOMEWIND_HISTORY_GAP, sizeof(s->ring));
+    s->head = 0;
+    s->bucket_sum = 0;
+    s->bucket_count = 0;
+    memset(chart_pixels(s), 0, CHART_STRIDE * CHART_H);
+    if (s->canvas) {
+        lv_obj_invalidate(s->canvas);
+    }
+}
+
+static void history_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    /* Sub-sample the latest values; `minutes` sub-samples make one column */
+    for (uint8_t i = 0; i < 2; i++) {
+        if (series[i].active) {
+            series[i].bucket_sum += series[i].current;
+            series[i].bucket_count++;
+        }
+    }
+    if (++subsample_ticks < history_minutes) return;
+    subsample_ticks = 0;
+    series_push(&series[HOMEWIND_HISTORY_HR]);
+    series_push(&series[HOMEWIND_HISTORY_CADENCE]);
+}
+
+/* ============================================================================
+ * Feed (LVGL task, from the applied UI model)
+ * ============================================================================ */
+
+void history_feed_hr(hr_state_t state, uint16_t value)
+{
+    /* 0 bpm = no reading yet */
+    series[HOMEWIND_HISTORY_HR].active = (state == HR_STATE_ACTIVE && value > 0);
+    series[HOMEWIND_HISTORY_HR].current = value;
+}
+
+void history_feed_cadence(csc_state_t state, uint16_t cadence)
+{
+    /* 0 rpm while connected is a real sample (not pedaling) */
+    series[HOMEWIND_HISTORY_CADENCE].active = (state == CSC_STATE_ACTIVE);
+    series[HOMEWIND_HISTORY_CADENCE].current = cadence;
+}
+
+static void update_window_label(void)
+{
+    if (!lbl_window) return;
+    char text[24];
+    snprintf(text, sizeof(text), "Last %d min", history_minutes);
+    lv_label_set_text(lbl_window, text);
+}
+
+void history_apply_config(void)
+{
+    uint8_t minutes = history_minutes_req;
+    if (minutes == history_minutes) return;
+    history_minutes = minutes;
+    subsample_ticks = 0;
+    series_reset(&series[HOMEWIND_HISTORY_HR]);
+    series_reset(&series[HOMEWIND_HISTORY_CADENCE]);
+    update_window_label();
+}
+
+void homewind_set_history_window(uint8_t minutes)
+{
+    if (minutes < HOMEWIND_HISTORY_MIN_MINUTES) minutes = HOMEWIND_HISTORY_MIN_MINUTES;
+    if (minutes > HOMEWIND_HISTORY_MAX_MINUTES) minutes = HOMEWIND_HISTORY_MAX_MINUTES;
+    history_minutes_req = minutes;
+}
+
+uint16_t homewind_get_history(homewind_history_series_t which, uint8_t *out, uint16_t max)
+{
+    if (which > HOMEWIND_HISTORY_CADENCE || !out) return 0;
+    history_series_t *s = &series[which];
+    uint16_t n = max < HOMEWIND_HISTORY_COLUMNS ? max : HOMEWIND_HISTORY_COLUMNS;
+    /* Newest n samples, oldest first */
+    uint16_t start = (s->head + HOMEWIND_HISTORY_COLUMNS - n) % HOMEWIND_HISTORY_COLUMNS;
+    for (uint16_t i = 0; i < n; i++) {
+        out[i] = s->ring[(start + i) % HOMEWIND_HISTORY_COLUMNS];
+    }
+    return n;
+}
+
+/* ============================================================================
+ * Panel (swipe-in from the right, on top of the main screen)
+ * ============================================================================ */
+
+static void panel_anim_ready_cb(lv_anim_t *a)
+{
+    LV_UNUSED(a);
+    if (!history_panel_visible) {
+        lv_obj_add_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+static void panel_slide(lv_coord_t from, lv_coord_t to)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, history_panel);
+    lv_anim_set_values(&a, from, to);
+    lv_anim_set_time(&a, PANEL_ANIMATION_TIME_MS);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
+    lv_anim_set_exec_cb(&a, (lv_anim_exec_xcb_t)lv_obj_set_x);
+    lv_anim_set_ready_cb(&a, panel_anim_ready_cb);
+    lv_anim_start(&a);
+}
+
+void homewind_show_history_panel(void)
+{
+    if (!history_panel || history_panel_visible) return;
+    lv_coord_t w = lv_disp_get_hor_res(lv_disp_get_default());
+    history_panel_visible = true;
+    lv_obj_clear_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    panel_slide(w, -2);
+}
+
+void homewind_hide_history_panel(void)
+{
+    if (!history_panel || !history_panel_visible) return;
+    lv_coord_t w = lv_disp_get_hor_res(lv_disp_get_default());
+    history_panel_visible = false;
+    panel_slide(lv_obj_get_x(history_panel), w);
+}
+
+static void main_gesture_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    if (lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_LEFT) {
+        on_user_activity();
+        homewind_show_history_panel();
+    }
+}
+
+static void panel_gesture_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    if (lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_RIGHT) {
+        homewind_hide_history_panel();
+    }
+}
+
+static void panel_close_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        homewind_hide_history_panel();
+    }
+}
+
+static lv_obj_t *create_series_card(lv_obj_t *parent, history_series_t *s, const char *title,
+                                     uint32_t color_hex)
+{
+    lv_obj_t *card = lv_obj_create(parent);  /* Geometry: history_apply_layout() */
+    lv_obj_set_style_radius(card, RADIUS_CARD, 0);
+    lv_obj_set_style_bg_color(card, lv_color_hex(COLOR_MODAL_CARD), 0);
+    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(card, 0, 0);
+    lv_obj_set_style_pad_all(card, CARD_PAD, 0);
+    lv_obj_set_style_pad_gap(card, 8, 0);
+    lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *lbl = lv_label_create(card);
+    lv_label_set_text(lbl, title);
+    lv_obj_set_style_text_color(lbl, lv_color_hex(color_hex), 0);
+    lv_obj_set_style_text_font(lbl, &lv_font_inter_bold_24, 0);
+
+    /* 1-bit indexed canvas: index 0 = card background, 1 = series color */
+    s->color = lv_color_hex(color_hex);
+    s->canvas = lv_canvas_create(card);
+    lv_canvas_set_buffer(s->canvas, s->canvas_buf, CHART_W, CHART_H, LV_IMG_CF_INDEXED_1BIT);
+    lv_canvas_set_palette(s->canvas, 0, lv_color_hex(COLOR_MODAL_CARD));
+    lv_canvas_set_palette(s->canvas, 1, s->color);
+    lv_obj_clear_flag(s->canvas, LV_OBJ_FLAG_CLICKABLE);
+    return card;
+}
+
+/* Portrait: cards stacked, Close across the bottom. Landscape: cards on the
+ * left (a chart keeps its 240 px), window label and Close on the right.
+ * Called on rotation with the panel's parent already resized. */
+void history_apply_layout(bool landscape)
+{
+    if (!history_panel) return;
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_coord_t w = lv_disp_get_hor_res(disp);
+    lv_coord_t h = lv_disp_get_ver_res(disp);
+
+    lv_obj_set_size(history_panel, w + 4, h + 6);  // +4 to cover all edges (like the settings modal)
+    if (!history_panel_visible) {
+        lv_obj_set_x(history_panel, w);  // Off-screen right
+    }
+
+    if (!landscape) {
+        for (int i = 0; i < 2; i++) {
+            lv_obj_set_size(cards[i], w - 2, CARD_H);
+            lv_obj_set_style_pad_ver(cards[i], CARD_PAD, 0);
+            lv_obj_align(cards[i], LV_ALIGN_TOP_MID, 0, i * (CARD_H + CARD_GAP));
+        }
+        lv_obj_align(lbl_window, LV_ALIGN_TOP_MID, 0, 2 * (CARD_H + CARD_GAP));
+        lv_obj_set_size(btn_close, w - 2, BUTTON_H);
+        lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, 0);
+    } else {
+        /* Panel content spans the screen (pad 2 inside the +4 width) */
+        lv_coord_t right_x = CARD_W_LANDSCAPE + CARD_GAP;
+        lv_coord_t right_w = w - right_x;
+        lv_coord_t right_mid = right_x + right_w / 2 - w / 2;
+        for (int i = 0; i < 2; i++) {
+            lv_obj_set_size(cards[i], CARD_W_LANDSCAPE, CARD_H_LANDSCAPE);
+            lv_obj_set_style_pad_ver(cards[i], CARD_PAD_LANDSCAPE, 0);
+            lv_obj_align(cards[i], LV_ALIGN_TOP_LEFT, 0, i * (CARD_H_LANDSCAPE + CARD_GAP_LANDSCAPE));
+        }
+        lv_obj_align(lbl_window, LV_ALIGN_TOP_MID, right_mid, CARD_PAD_LANDSCAPE);
+        lv_obj_set_size(btn_close, right_w, BUTTON_H);
+        lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, right_mid, 0);
+    }
+}
+
+void history_create_panel(lv_obj_t *parent)
+{
+    if (history_panel) return;
+    mem_stats_account(HOMEWIND_MEM_HISTORY, sizeof(series));
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_coord_t w = lv_disp_get_hor_res(disp);
+    lv_coord_t h = lv_disp_get_ver_res(disp);
+
+    series_reset(&series[HOMEWIND_HISTORY_HR]);
+    series_reset(&series[HOMEWIND_HISTORY_CADENCE]);
+
+    history_panel = lv_obj_create(parent);
+    lv_obj_set_size(history_panel, w + 4, h + 6);  // +4 to cover all edges (like the settings modal)
+    lv_obj_set_style_bg_color(history_panel, lv_color_hex(COLOR_MODAL_BG), 0);
+    lv_obj_set_style_border_width(history_panel, 0, 0);
+    lv_obj_set_style_pad_all(history_panel, 2, 0);
+    lv_obj_set_style_pad_top(history_panel, 6, 0);  // Content starts at the top screen edge
+    lv_obj_clear_flag(history_panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(history_panel, w, -6);  // Off-screen right
+    lv_obj_add_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_event_cb(history_panel, panel_gesture_cb, LV_EVENT_GESTURE, NULL);
+
+    cards[HOMEWIND_HISTORY_HR] =
+        create_series_card(history_panel, &series[HOMEWIND_HISTORY_HR], "Heart Rate", COLOR_ACCENT);
+    cards[HOMEWIND_HISTORY_CADENCE] =
+        create_series_card(history_panel, &series[HOMEWIND_HISTORY_CADENCE], "Cadence", COLOR_CSC);
+
+    lbl_window = lv_label_create(history_panel);
+    lv_obj_set_style_text_color(lbl_window, lv_color_hex(COLOR_DISCONNECTED), 0);
+    lv_obj_set_style_text_font(lbl_window, &lv_font_inter_bold_14, 0);
+    update_window_label();
+
+    /* Close Button (same look as the settings modal) */
+    btn_close = lv_btn_create(history_panel);
+    lv_obj_set_style_bg_color(btn_close, lv_color_hex(COLOR_ACCENT), 0);
+    lv_obj_set_style_radius(btn_close, RADIUS_BUTTON, 0);
+    lv_obj_add_event_cb(btn_close, panel_close_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *lbl_close = lv_label_create(btn_close);
+    lv_label_set_text(lbl_close, "Close");
+    lv_obj_set_style_text_font(lbl_close, &lv_font_inter_bold_24, 0);
+    lv_obj_center(lbl_close);
+    lv_obj_set_style_translate_y(lbl_close, 2, 0);
+
+    /* Swipe left anywhere on the main screen opens the panel */
+    lv_obj_add_event_cb(parent, main_gesture_cb, LV_EVENT_GESTURE, NULL);
+
+    history_apply_layout(w > h);
+
+    if (!history_timer) {
+        history_timer = lv_timer_create(history_timer_cb, HISTORY_SUBSAMPLE_MS, NULL);
+        lcd_lvgl_add_low_priority_timer(history_timer);
+    }
+}
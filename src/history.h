@@ -0,0 +1,64 @@
+#pragma once
+#include "lvgl.h"
+#include "homewind_ui.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * HR / Cadence History
+ * ============================================================================
+ * Fixed-size ring buffer per series, one decimated sample per chart column.
+ * The LVGL task sub-samples the current values every 250 ms and averages
+ * `minutes` sub-samples into one column, so RAM and CPU per sample are the
+ * same for a 10 or a 30 minute window. The chart bitmap is scrolled by one
+ * pixel and only the new column is drawn.
+ * ============================================================================ */
+
+#define HOMEWIND_HISTORY_COLUMNS          240  /* Samples per series (= chart width in px) */
+#define HOMEWIND_HISTORY_MIN_MINUTES      10
+#define HOMEWIND_HISTORY_MAX_MINUTES      30
+#define HOMEWIND_HISTORY_DEFAULT_MINUTES  15
+#define HOMEWIND_HISTORY_GAP              0xFF /* Sample value: sensor not active */
+
+typedef enum {
+    HOMEWIND_HISTORY_HR = 0,
+    HOMEWIND_HISTORY_CADENCE
+} homewind_history_series_t;
+
+/**
+ * @brief Set the history window (clamped to 10-30 minutes, default 15)
+ * Safe from any task; applied by the LVGL task. Changing the window clears
+ * the recorded history.
+ */
+void homewind_set_history_window(uint8_t minutes);
+
+/**
+ * @brief Copy a series oldest-first (LVGL task / with LVGL lock)
+ * @param out Destination, values in bpm / rpm (capped at 254), HOMEWIND_HISTORY_GAP for gaps
+ * @param max Capacity of out
+ * @return Number of samples copied
+ */
+uint16_t homewind_get_history(homewind_history_series_t series, uint8_t *out, uint16_t max);
+
+/**
+ * @brief Show / hide the history panel (LVGL context)
+ * The panel also opens with a left swipe on the main screen and closes with
+ * a right swipe or its Close button.
+ */
+void homewind_show_history_panel(void);
+void homewind_hide_history_panel(void);
+
+/* --- Internal (library, LVGL task) --- */
+void history_create_panel(lv_obj_t *parent);
+void history_feed_hr(hr_state_t state, uint16_t value);
+void history_feed_cadence(csc_state_t state, uint16_t cadence);
+void history_apply_config(void);
+void history_apply_layout(bool landscape);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,8 +5,18 @@
 #include "lvgl.h"
 #include "ui_colors.h"
 #include "ui_style_helpers.h"
-#include "extra/libs/qrcode/lv_qrcode.h" // LVGL QR code library (part of LVGL)
+#include "extra/libs/qrcode/qrcodegen.h" // QR encoder bundled with LVGL (LV_USE_QRCODE)
 #include "qmi8658c.h"  // For QMI8658_SLAVE_ADDR_L conditional IMU support
+#include "init_profile.h"
+#include "heap_guard.h"
+#include "mem_stats.h"
+#include "event_trace.h"
+#include "ui_state.h"
+#include "history.h"
+#include "sensor_filter.h"
+#include "lcd_bsp.h"
+#include "FT3168.h"
+#include "imu_fusion.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -33,6 +43,10 @@ LV_FONT_DECLARE(lv_font_icon_56);
 #define FAN_TOGGLE_ANIMATION_TIME_MS  300  // Animation duration for fan toggle
 #define FAN_ANIM_RESOLUTION  1024  // Animation resolution for color interpolation
 
+/* --- QR Code --- */
+#define QR_CODE_MAX_SIZE_PX      220  // Upper bound for the QR widget edge length
+#define QR_CODE_MAX_VERSION      10   // 57x57 modules, enough for a 127-char URL at ECC medium
+
 /* --- Global Objects --- */
 lv_obj_t *scr_main;  // Made non-static for powersave module access
 static lv_obj_t *scr_boot = NULL;
@@ -40,10 +54,11 @@ static lv_obj_t *scr_apmode = NULL;
 static lv_obj_t *settings_overlay = NULL;
 static lv_obj_t *settings_card = NULL;
 static lv_obj_t *qr_code_widget = NULL;
+static lv_obj_t *btn_settings = NULL;
+static lv_obj_t *btn_modal_close = NULL;
 
 /* FIX Issue #2: Track modal visibility to skip LVGL updates when not visible */
 static bool settings_modal_visible = false;
-static bool ui_refresh_pending = false;  // Flag to refresh UI on modal close
 
 /* --- HR Widget Objects --- */
 static lv_obj_t *card_hr;
@@ -60,51 +75,150 @@ static lv_obj_t *csc_icon_label;  // Error icon (U+33) for inactive/error states
 static lv_obj_t *csc_checkmark_label;  // Checkmark icon (U+32) for active state
 static lv_obj_t *lbl_csc_sensor_name;
 static lv_obj_t *lbl_csc_status;
-static csc_state_t csc_current_state = CSC_NOT_CONFIGURATED;
-static char csc_sensor_name[32] = "CSC Sensor";
-static uint16_t csc_cadence_value = 0;
 
-/* --- Fan Widget Objects (Figma: pill + circle + state text only) --- */
-#define MAX_FANS 4
-static lv_obj_t *fan_container;
+/* --- Fan Widget Objects (Figma: pill + circle + state text only) ---
+ * Virtualised list: fans sit in a grid (2 columns in portrait, 1 in
+ * landscape) inside a viewport two rows high. Only FAN_POOL_SIZE pills
+ * exist; fan i is always drawn by slot i % FAN_POOL_SIZE, which is rebound
+ * when its row scrolls into the window, so object count and render cost
+ * stay flat as the fan count grows. */
+#define FAN_COLUMNS_MAX    2
+#define FAN_PILL_H         64
+#define FAN_GAP            12
+#define FAN_ROW_PITCH      (FAN_PILL_H + FAN_GAP)
+#define FAN_VISIBLE_ROWS   2
+#define FAN_VIEWPORT_H     (FAN_VISIBLE_ROWS * FAN_ROW_PITCH - FAN_GAP)
+#define FAN_POOL_ROWS      (FAN_VISIBLE_ROWS + 1)  /* + the row partially visible while scrolling */
+#define FAN_POOL_SIZE      (FAN_POOL_ROWS * FAN_COLUMNS_MAX)
+static uint8_t fan_columns = FAN_COLUMNS_MAX;  /* From the active layout */
+static lv_coord_t fan_pill_w = 133;
+static lv_obj_t *fan_container;    /* Scroll viewport */
+static lv_obj_t *fan_list_spacer;  /* Extends the scroll range to the last row */
 static struct {
     lv_obj_t *card;       /* Pill-shaped container */
     lv_obj_t *icon_group;  /* Circle only (green=off, white=on); hidden for Error/Not Configurated */
     lv_obj_t *lbl_name;    /* State text: "Off", "On", "Error"; hidden for Not Configurated */
-    fan_state_t state;
-    bool is_on;
-} fan_items[MAX_FANS];
+    int8_t fan;            /* Bound fan index, -1 = unused (hidden) */
+    bool shown_valid;      /* shown_* describe what the pill currently draws */
+    fan_state_t shown_state;
+    bool shown_on;
+} fan_slots[FAN_POOL_SIZE];
+
+/* --- Orientation Layouts ---
+ * Main screen geometry for portrait (0/180 deg) and landscape (90/270 deg,
+ * e.g. handlebar mount), both computed once after the screen is built.
+ * A rotation only copies the cached rects onto the objects: the screen is
+ * never rebuilt and there is no full layout pass. */
+#define STACK_GAP             12
+#define HR_CARD_H             144
+#define CSC_CARD_H            64
+#define BUTTON_H              72
+#define LANDSCAPE_LEFT_W      264  /* HR + CSC column; the CSC label group needs 189 px */
+#define MODAL_QR_TEXT_RESERVE 106  /* Card height below/around the QR: padding + "Scan to Setup" */
+
+typedef struct {
+    lv_align_t align;
+    lv_coord_t x, y, w, h;
+} ui_rect_t;
 
-/* --- Fan UI Cache (for dirty-checking in update_fan_item) --- */
 typedef struct {
-    fan_state_t state;
-    bool is_on;
-    bool initialized;
-} fan_ui_cache_t;
-static fan_ui_cache_t fan_ui_cache[MAX_FANS] = {0};
+    ui_rect_t hr;
+    ui_rect_t csc;
+    ui_rect_t fans;
+    ui_rect_t settings_btn;
+    ui_rect_t modal_card;
+    ui_rect_t modal_close;
+    lv_coord_t qr_size;
+    lv_coord_t fan_pill_w;
+    uint8_t fan_columns;
+} ui_layout_t;
+
+typedef enum {
+    UI_LAYOUT_PORTRAIT = 0,
+    UI_LAYOUT_LANDSCAPE,
+    UI_LAYOUT_COUNT
+} ui_layout_id_t;
+
+static ui_layout_t ui_layouts[UI_LAYOUT_COUNT];
+static ui_layout_id_t ui_layout_current = UI_LAYOUT_PORTRAIT;
 
 /* --- Fan Toggle Callback --- */
 typedef void (*fan_toggle_callback_t)(uint8_t fan_index, bool is_on);
 static fan_toggle_callback_t fan_toggle_callback = NULL;
 
-/* --- State Variables --- */
-static hr_state_t hr_current_state = HR_NOT_CONFIGURATED;
-static uint16_t hr_value = 0;
-static char hr_sensor_name[32] = "";
+/* --- UI Model ---
+ * Single source of truth for what the views show. Filled from the ui_state
+ * mailbox (LVGL task only). Every change raises UI_FIELD_* bits in each
+ * view's dirty mask; a view diffs those fields against the snapshot of what
+ * it last rendered, so only real differences reach LVGL. */
+typedef struct {
+    hr_state_t hr_state;
+    uint16_t hr_value;
+    char hr_name[32];
+    csc_state_t csc_state;
+    uint16_t csc_cadence;
+    char csc_name[32];
+    fan_state_t fan_state[HOMEWIND_MAX_FANS];
+    bool fan_on[HOMEWIND_MAX_FANS];
+    uint8_t fan_count;        /* Fans shown in the list */
+    uint8_t fans_configured;  /* Maintained counters over fans < fan_count */
+    uint8_t fans_on;
+} ui_model_t;
+
+static ui_model_t ui_model = {
+    .hr_state = HR_NOT_CONFIGURATED,
+    .csc_state = CSC_NOT_CONFIGURATED,
+    .csc_name = "CSC Sensor",
+    .fan_count = HOMEWIND_DEFAULT_FAN_COUNT,
+};
 static char qr_code_url[128] = "https://martin-lihs.com";
 
+/* --- Main view: pending fields + last-rendered snapshot --- */
+#define MAIN_VIEW_FIELDS (UI_FIELDS_HR | UI_FIELDS_CSC | UI_FIELD_FAN_COUNT | UI_FIELD_FANS_ALL)
+static uint32_t main_view_dirty = MAIN_VIEW_FIELDS;  /* Changed, not yet rendered */
+static uint32_t main_shown_valid = 0;                /* Fields present in main_shown */
+static ui_model_t main_shown;
+
+/* --- Refresh Scheduling ---
+ * Sensors may report far faster than anyone can read the numbers. Each widget
+ * has a minimum interval between value renders; values arriving sooner stay
+ * in the mailbox (latest wins) and are applied when the interval is over.
+ * NORMAL-priority widgets also wait while a finger is on the panel, so touch
+ * feedback gets the frames to itself. State/name changes are never held. */
+#define REFRESH_TOUCH_RECHECK_MS    30    /* ~ one touch poll */
+#define REFRESH_TOUCH_MAX_HOLD_MS   1000  /* Long press / scroll: let values through */
+
+typedef struct {
+    uint32_t widget_fields;         /* All fields of the widget */
+    uint32_t value_fields;          /* Fields subject to the cap */
+    volatile uint16_t interval_ms;  /* 0 = render immediately */
+    volatile uint8_t priority;      /* homewind_refresh_priority_t */
+    uint32_t last_apply_ms;
+} widget_refresh_t;
+
+static widget_refresh_t widget_refresh[HOMEWIND_WIDGET_COUNT] = {
+    [HOMEWIND_WIDGET_HR]   = { UI_FIELDS_HR,  UI_FIELD_HR_VALUE,    1000 / 2, HOMEWIND_REFRESH_NORMAL, 0 },
+    [HOMEWIND_WIDGET_CSC]  = { UI_FIELDS_CSC, UI_FIELD_CSC_CADENCE, 1000 / 4, HOMEWIND_REFRESH_NORMAL, 0 },
+    [HOMEWIND_WIDGET_FANS] = { UI_FIELD_FANS_ALL | UI_FIELD_FAN_COUNT, UI_FIELD_FANS_ALL, 0, HOMEWIND_REFRESH_HIGH, 0 },
+};
+static lv_timer_t *refresh_timer = NULL;  /* Applies held values when their interval ends */
+
+/* --- QR module matrix (1 bit per module, encoded once per URL) ---
+ * Replaces the lv_qrcode canvas: instead of a full-size pixel buffer we keep
+ * the qrcodegen bitmap (~400 bytes at version 10) and scale it while drawing.
+ * Encoding is lazy – it runs when the settings modal opens, not in the caller
+ * of homewind_set_qr_code_url(). */
+static uint8_t qr_modules[qrcodegen_BUFFER_LEN_FOR_VERSION(QR_CODE_MAX_VERSION)];
+static uint8_t qr_encode_tmp[qrcodegen_BUFFER_LEN_FOR_VERSION(QR_CODE_MAX_VERSION)];
+static int qr_module_count = 0;   /* Modules per side, 0 = nothing to draw */
+static bool qr_code_dirty = true; /* URL changed since last encode */
+
 /* --- Cached formatted strings (avoid repeated snprintf calls) --- */
 static char hr_value_str[8] = "--";
 static uint16_t hr_value_str_cached = 0xFFFF;  /* Force first format */
 static char csc_cadence_str[16] = "0 RPM";
 static uint16_t csc_cadence_str_cached = 0;
 
-/* --- HR widget cache (reduces redundant LVGL updates) --- */
-static hr_state_t hr_widget_cache_state = (hr_state_t)-1;
-static uint16_t hr_widget_cache_value = 0xFFFF;
-static char hr_widget_cache_name[32] = "";
-static bool hr_widget_cache_initialized = false;
-
 /* ============================================================================
  * O3: Pre-defined Styles (created once, reused on state changes)
  * ============================================================================
@@ -145,6 +259,7 @@ static void anim_overlay_out_ready_cb(lv_anim_t *a);
 static void settings_btn_event_cb(lv_event_t *e);
 static void close_btn_event_cb(lv_event_t *e);
 static void fan_toggle_event_cb(lv_event_t *e);
+static void fan_list_scroll_event_cb(lv_event_t *e);
 static void create_boot_screen(void);
 static void create_ap_screen(void);
 static void create_main_screen(void);
@@ -155,9 +270,21 @@ static void create_settings_modal(void);
 static void update_hr_widget(void);
 static void update_csc_widget(void);
 static void update_fan_item(uint8_t index);
+static void render_fan_slot(uint8_t slot);
+static void fan_list_bind_window(void);
+static void fan_list_update_range(void);
+static void ui_layout_compute(ui_layout_t *l, lv_coord_t w, lv_coord_t h);
+static void ui_layout_apply(ui_layout_id_t id);
+static void ui_layout_rotation_cb(lv_disp_rot_t rotation);
+static void render_main_view(void);
+static void update_powersave_display(void);
 static void animate_fan_toggle(uint8_t index);
 static const char* get_hr_value_string(void);
 static bool should_skip_main_screen_update(void);
+static void qr_code_encode_if_dirty(void);
+static void ui_frame_hook(void);
+static void homewind_apply_pending(void);
+static void refresh_timer_cb(lv_timer_t *timer);
 
 static void start_anim(lv_anim_t *anim, void *var, int32_t from, int32_t to, uint32_t time_ms,
                        lv_anim_path_cb_t path_cb, lv_anim_exec_xcb_t exec_cb,
@@ -186,7 +313,9 @@ static void animate_overlay_in(void)
 
     /* FIX Issue #2: Mark modal as visible (skip UI updates while open) */
     settings_modal_visible = true;
-    ui_refresh_pending = false;
+
+    /* Encode the QR matrix now (first open or URL changed) */
+    qr_code_encode_if_dirty();
 
     lv_obj_set_y(settings_overlay, h + 6);  // Start from off-screen position
     lv_obj_clear_flag(settings_overlay, LV_OBJ_FLAG_HIDDEN);
@@ -201,26 +330,9 @@ static void anim_overlay_out_ready_cb(lv_anim_t *a)
     LV_UNUSED(a);
     lv_obj_add_flag(settings_overlay, LV_OBJ_FLAG_HIDDEN);
     
-    /* FIX Issue #2: Mark modal as hidden and refresh UI if changes occurred */
+    /* FIX Issue #2: Mark modal as hidden and render what changed meanwhile */
     settings_modal_visible = false;
-    if (ui_refresh_pending) {
-        ui_refresh_pending = false;
-        /* Force refresh all widgets by invalidating caches */
-        /* HR widget uses hr_value_str_cached, CSC uses csc_cadence_str_cached */
-        /* Fan widget uses fan_ui_cache[] - we need to reset initialized flag */
-        hr_widget_cache_initialized = false;
-        for (uint8_t i = 0; i < MAX_FANS; i++) {
-            fan_ui_cache[i].initialized = false;
-        }
-        /* Trigger full UI update */
-        update_hr_widget();
-        update_csc_widget();
-        for (uint8_t i = 0; i < MAX_FANS; i++) {
-            if (fan_items[i].card) {
-                update_fan_item(i);
-            }
-        }
-    }
+    render_main_view();
 }
 
 static void animate_overlay_out(void)
@@ -241,8 +353,8 @@ typedef struct {
     uint8_t fan_index;  // To identify which fan this belongs to
 } fan_color_anim_data_t;
 
-// Static animation data for all fans (avoids lv_mem_alloc/free per animation)
-static fan_color_anim_data_t fan_anim_data[MAX_FANS];
+// Static animation data per pill slot (avoids lv_mem_alloc/free per animation)
+static fan_color_anim_data_t fan_anim_data[FAN_POOL_SIZE];
 
 static void fan_bg_color_anim_cb(void *var, int32_t value)
 {
@@ -291,16 +403,18 @@ static void fan_color_anim_ready_cb(lv_anim_t *a)
 
 static void animate_fan_toggle(uint8_t index)
 {
-    if (index >= MAX_FANS || !fan_items[index].card) return;
+    if (index >= HOMEWIND_MAX_FANS) return;
+    uint8_t slot = index % FAN_POOL_SIZE;
+    if (fan_slots[slot].fan != (int8_t)index || !fan_slots[slot].card) return;  /* Not in view */
     
-    /* Use static animation data for this fan index */
-    fan_color_anim_data_t *data = &fan_anim_data[index];
+    /* Use static animation data for this pill slot */
+    fan_color_anim_data_t *data = &fan_anim_data[slot];
     
     /* Stop any existing animation on this fan first */
     lv_anim_del(data, (lv_anim_exec_xcb_t)fan_bg_color_anim_cb);
     
     /* Get current background color */
-    lv_color_t start_color = lv_obj_get_style_bg_color(fan_items[index].card, 0);
+    lv_color_t start_color = lv_obj_get_style_bg_color(fan_slots[slot].card, 0);
     
     /* Convert lv_color_t to hex (RGB format: 0xRRGGBB) */
     uint32_t start_color_hex = 0;
@@ -325,23 +439,23 @@ static void animate_fan_toggle(uint8_t index)
     
     /* Determine end color hex based on state and is_on */
     uint32_t end_color_hex;
-    if (fan_items[index].state == FAN_STATE_NOT_CONFIGURATED) {
+    if (ui_model.fan_state[index] == FAN_STATE_NOT_CONFIGURATED) {
         return;  // No animation for not configured
     }
-    if (fan_items[index].state == FAN_STATE_ACTIVE) {
-        end_color_hex = fan_items[index].is_on ? 
+    if (ui_model.fan_state[index] == FAN_STATE_ACTIVE) {
+        end_color_hex = ui_model.fan_on[index] ? 
             COLOR_FAN_ACTIVE_ON : 
             COLOR_WHITE;
-    } else if (fan_items[index].state == FAN_STATE_ERROR) {
+    } else if (ui_model.fan_state[index] == FAN_STATE_ERROR) {
         return;  /* Error has no on/off, no animation */
-    } else if (fan_items[index].state == FAN_STATE_INACTIVE) {
+    } else if (ui_model.fan_state[index] == FAN_STATE_INACTIVE) {
         end_color_hex = COLOR_WHITE;  // Fan off pill
     } else {
         return;
     }
     
     /* Setup static animation data (no heap allocation!) */
-    data->obj = fan_items[index].card;
+    data->obj = fan_slots[slot].card;
     data->start_color_hex = start_color_hex;
     data->end_color_hex = end_color_hex;
     data->fan_index = index;
@@ -353,6 +467,39 @@ static void animate_fan_toggle(uint8_t index)
                fan_color_anim_ready_cb, data);
 }
 
+/* --- Fan model + O(1) counters (configured = any state except NOT_CONFIGURATED) --- */
+static void fan_counters_add(uint8_t index, bool add)
+{
+    if (index >= ui_model.fan_count) return;
+    if (ui_model.fan_state[index] == FAN_STATE_NOT_CONFIGURATED) return;
+    if (add) {
+        ui_model.fans_configured++;
+        if (ui_model.fan_on[index]) ui_model.fans_on++;
+    } else {
+        ui_model.fans_configured--;
+        if (ui_model.fan_on[index]) ui_model.fans_on--;
+    }
+}
+
+static void model_set_fan(uint8_t index, fan_state_t state, bool is_on)
+{
+    fan_counters_add(index, false);
+    ui_model.fan_state[index] = state;
+    ui_model.fan_on[index] = is_on;
+    fan_counters_add(index, true);
+}
+
+static void model_set_fan_count(uint8_t count)
+{
+    /* Rare (configuration change): recount once instead of per update */
+    ui_model.fan_count = count;
+    ui_model.fans_configured = 0;
+    ui_model.fans_on = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        fan_counters_add(i, true);
+    }
+}
+
 /* --- Event Handlers --- */
 static void settings_btn_event_cb(lv_event_t *e)
 {
@@ -372,25 +519,30 @@ static void fan_toggle_event_cb(lv_event_t *e)
 {
     if (lv_event_get_code(e) != LV_EVENT_CLICKED) return;
     on_user_activity();  /* wake from DIMMED + reset timer (event goes to widget, not scr_main) */
-    uint8_t fan_index = (uint8_t)(intptr_t)lv_event_get_user_data(e);
-    if (fan_index >= MAX_FANS) return;
+    uint8_t slot = (uint8_t)(intptr_t)lv_event_get_user_data(e);
+    if (slot >= FAN_POOL_SIZE || fan_slots[slot].fan < 0) return;
+    uint8_t fan_index = (uint8_t)fan_slots[slot].fan;
     
-    if (fan_items[fan_index].state == FAN_STATE_NOT_CONFIGURATED) return;
-    if (fan_items[fan_index].state == FAN_STATE_INACTIVE) return;  /* not toggleable */
+    if (ui_model.fan_state[fan_index] == FAN_STATE_NOT_CONFIGURATED) return;
+    if (ui_model.fan_state[fan_index] == FAN_STATE_INACTIVE) return;  /* not toggleable */
     
     /* Error: no is_on toggle, only callback (e.g. for retry or message) */
-    if (fan_items[fan_index].state == FAN_STATE_ERROR) {
+    if (ui_model.fan_state[fan_index] == FAN_STATE_ERROR) {
         if (fan_toggle_callback) fan_toggle_callback(fan_index, false);
         return;
     }
     
     /* ACTIVE: toggle is_on, callback, update UI */
-    fan_items[fan_index].is_on = !fan_items[fan_index].is_on;
+    model_set_fan(fan_index, ui_model.fan_state[fan_index], !ui_model.fan_on[fan_index]);
+    /* Keep the mailbox in sync (UI is updated right here, nothing to publish) */
+    ui_state_set_fan_on(fan_index, ui_model.fan_on[fan_index], false, xTaskGetCurrentTaskHandle());
     if (fan_toggle_callback) {
-        fan_toggle_callback(fan_index, fan_items[fan_index].is_on);
+        fan_toggle_callback(fan_index, ui_model.fan_on[fan_index]);
     }
+    main_view_dirty |= UI_FIELD_FAN(fan_index);
     update_fan_item(fan_index);
     animate_fan_toggle(fan_index);
+    update_powersave_display();
 }
 
 /* --- HR Widget --- */
@@ -399,8 +551,7 @@ static void create_hr_widget(lv_obj_t *parent)
     lv_disp_t *disp = lv_disp_get_default();
     lv_coord_t w = lv_disp_get_hor_res(disp);
 
-    card_hr = lv_obj_create(parent);
-    lv_obj_set_size(card_hr, LV_PCT(100), 144);
+    card_hr = lv_obj_create(parent);  /* Geometry: ui_layout_apply() */
     lv_obj_set_style_bg_color(card_hr, lv_color_hex(COLOR_ACCENT), 0);
     lv_obj_set_style_bg_opa(card_hr, LV_OPA_COVER, 0);
     lv_obj_set_style_radius(card_hr, RADIUS_CARD, 0);
@@ -446,7 +597,7 @@ static void create_hr_widget(lv_obj_t *parent)
 
     /* Sensor Name Label */
     lbl_hr_sensor_name = lv_label_create(card_hr);
-    lv_label_set_text(lbl_hr_sensor_name, hr_sensor_name);
+    lv_label_set_text(lbl_hr_sensor_name, ui_model.hr_name);
     lv_obj_set_style_text_color(lbl_hr_sensor_name, lv_color_white(), 0);
     lv_obj_set_style_text_font(lbl_hr_sensor_name, &lv_font_inter_bold_24, 0);
     lv_obj_align(lbl_hr_sensor_name, LV_ALIGN_BOTTOM_MID, 0, -4);
@@ -455,51 +606,26 @@ static void create_hr_widget(lv_obj_t *parent)
     update_hr_widget();
 }
 
-/* --- Helper: count configured fans (any state except NOT_CONFIGURATED) --- */
-static uint8_t count_configured_fans(void)
-{
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_FANS; i++) {
-        if (fan_items[i].state != FAN_STATE_NOT_CONFIGURATED) {
-            count++;
-        }
-    }
-    return count;
-}
-
-/* --- Helper: count fans that are currently ON (among configured) --- */
-static uint8_t count_fans_on(void)
-{
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_FANS; i++) {
-        if (fan_items[i].state != FAN_STATE_NOT_CONFIGURATED && fan_items[i].is_on) {
-            count++;
-        }
-    }
-    return count;
-}
-
 /* --- Update powersave screen when sensor states change --- */
 static void update_powersave_display(void)
 {
-    uint8_t fan_configured = count_configured_fans();
-    uint8_t fan_active_count = count_fans_on();
-    update_powersave_icons(hr_current_state, csc_current_state,
-                          hr_value, csc_cadence_value, fan_active_count, fan_configured);
+    update_powersave_icons(ui_model.hr_state, ui_model.csc_state,
+                          ui_model.hr_value, ui_model.csc_cadence,
+                          ui_model.fans_on, ui_model.fans_configured);
 }
 
 /* Helper: Get cached HR value string (only format if value changed) */
 static const char* get_hr_value_string(void)
 {
-    if (hr_value != hr_value_str_cached) {
-        if (hr_value == 0) {
+    if (ui_model.hr_value != hr_value_str_cached) {
+        if (ui_model.hr_value == 0) {
             hr_value_str[0] = '-';
             hr_value_str[1] = '-';
             hr_value_str[2] = '\0';
         } else {
-            snprintf(hr_value_str, sizeof(hr_value_str), "%d", hr_value);
+            snprintf(hr_value_str, sizeof(hr_value_str), "%d", ui_model.hr_value);
         }
-        hr_value_str_cached = hr_value;
+        hr_value_str_cached = ui_model.hr_value;
     }
     return hr_value_str;
 }
@@ -507,124 +633,120 @@ static const char* get_hr_value_string(void)
 /* Helper: Get cached CSC cadence string (only format if value changed) */
 static const char* get_csc_cadence_string(void)
 {
-    if (csc_cadence_value != csc_cadence_str_cached) {
-        snprintf(csc_cadence_str, sizeof(csc_cadence_str), "%d RPM", csc_cadence_value);
-        csc_cadence_str_cached = csc_cadence_value;
+    if (ui_model.csc_cadence != csc_cadence_str_cached) {
+        snprintf(csc_cadence_str, sizeof(csc_cadence_str), "%d RPM", ui_model.csc_cadence);
+        csc_cadence_str_cached = ui_model.csc_cadence;
     }
     return csc_cadence_str;
 }
 
 static bool should_skip_main_screen_update(void)
 {
-    /* Boot/AP/Powersave screen active: skip main screen updates */
-    if (lv_scr_act() != scr_main) {
-        if (get_ui_power_state() == UI_POWER_STATE_SOFT_POWERSAVE) {
-            update_powersave_display();
-        }
-        return true;
-    }
-
-    if (settings_modal_visible) {
-        ui_refresh_pending = true;
-        return true;
-    }
-
-    return false;
+    /* Boot/AP/Powersave screen active or modal open: keep fields dirty
+     * and render them when the main screen is visible again */
+    return lv_scr_act() != scr_main || settings_modal_visible;
 }
 
 static void update_hr_widget(void)
 {
-    if (should_skip_main_screen_update()) {
-        return;
+    if (!(main_view_dirty & UI_FIELDS_HR)) return;
+    if (should_skip_main_screen_update()) return;
+    main_view_dirty &= ~UI_FIELDS_HR;
+
+    /* Diff against what the widget shows right now */
+    bool shown = (main_shown_valid & UI_FIELDS_HR) == UI_FIELDS_HR;
+    bool state_changed = !shown || ui_model.hr_state != main_shown.hr_state;
+    bool value_changed = !shown || ui_model.hr_value != main_shown.hr_value;
+    bool name_changed = !shown || strcmp(ui_model.hr_name, main_shown.hr_name) != 0;
+
+    main_shown.hr_state = ui_model.hr_state;
+    main_shown.hr_value = ui_model.hr_value;
+    memcpy(main_shown.hr_name, ui_model.hr_name, sizeof(main_shown.hr_name));
+    main_shown_valid |= UI_FIELDS_HR;
+
+    /* Layout: icon/value visibility only depends on the state */
+    if (state_changed) {
+        switch (ui_model.hr_state) {
+            case HR_STATE_ACTIVE:
+                /* Active: Show HR value and heart icon */
+                if (lbl_hr_value) {
+                    lv_obj_clear_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_heart) {
+                    lv_obj_clear_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_disconnected) {
+                    lv_obj_add_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
+                    lv_obj_set_style_translate_y(lbl_hr_disconnected, -2, 0);
+                }
+                lv_obj_set_style_translate_y(row_value, 0, 0);
+                break;
+
+            case HR_STATE_INACTIVE:
+                /* Inactive: Sensor configured but not connected - show name + "Not Connected" */
+                if (lbl_hr_value) {
+                    lv_obj_add_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_heart) {
+                    lv_obj_add_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_disconnected) {
+                    lv_obj_clear_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
+                    lv_obj_set_style_translate_y(row_value, -10, 0);
+                }
+                break;
+
+            case HR_NOT_CONFIGURATED:
+                /* Not configured: Show disconnected icon and "Not Configured" */
+                if (lbl_hr_value) {
+                    lv_obj_add_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_heart) {
+                    lv_obj_add_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
+                }
+                if (lbl_hr_disconnected) {
+                    lv_obj_clear_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
+                    lv_obj_set_style_translate_y(lbl_hr_disconnected, -2, 0);
+                }
+                lv_obj_set_style_translate_y(row_value, 0, 0);
+                break;
+        }
     }
 
-    if (hr_widget_cache_initialized &&
-        hr_widget_cache_state == hr_current_state &&
-        hr_widget_cache_value == hr_value &&
-        strncmp(hr_widget_cache_name, hr_sensor_name, sizeof(hr_widget_cache_name)) == 0) {
-        return;  /* No visual change needed */
+    /* Value label is only visible while active */
+    if (lbl_hr_value && ui_model.hr_state == HR_STATE_ACTIVE && (state_changed || value_changed)) {
+        lv_label_set_text(lbl_hr_value, get_hr_value_string());
     }
 
-    hr_widget_cache_state = hr_current_state;
-    hr_widget_cache_value = hr_value;
-    strncpy(hr_widget_cache_name, hr_sensor_name, sizeof(hr_widget_cache_name) - 1);
-    hr_widget_cache_name[sizeof(hr_widget_cache_name) - 1] = '\0';
-    hr_widget_cache_initialized = true;
-
-    switch (hr_current_state) {
-        case HR_STATE_ACTIVE:
-            /* Active: Show HR value and heart icon */
-            if (lbl_hr_value) {
-                lv_obj_clear_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
-                lv_label_set_text(lbl_hr_value, get_hr_value_string());
-            }
-            if (lbl_hr_heart) {
-                lv_obj_clear_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (lbl_hr_disconnected) {
-                lv_obj_add_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_set_style_translate_y(lbl_hr_disconnected, -2, 0);
-            }
-            lv_obj_set_style_translate_y(row_value, 0, 0);
-            if (lbl_hr_sensor_name) {
-                lv_label_set_text(lbl_hr_sensor_name, hr_sensor_name);
+    /* Name label text depends on state + name */
+    if (lbl_hr_sensor_name && (state_changed || name_changed)) {
+        switch (ui_model.hr_state) {
+            case HR_STATE_ACTIVE:
+                lv_label_set_text(lbl_hr_sensor_name, ui_model.hr_name);
                 lv_obj_set_style_translate_y(lbl_hr_sensor_name, 0, 0);
-            }
-            break;
-            
-        case HR_STATE_INACTIVE:
-            /* Inactive: Sensor configured but not connected - show name + "Not Connected" */
-            if (lbl_hr_value) {
-                lv_obj_add_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (lbl_hr_heart) {
-                lv_obj_add_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (lbl_hr_disconnected) {
-                lv_obj_clear_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_set_style_translate_y(row_value, -10, 0);
-            }
-            if (lbl_hr_sensor_name) {
-                if (hr_sensor_name && strlen(hr_sensor_name) > 0) {
+                break;
+            case HR_STATE_INACTIVE:
+                if (ui_model.hr_name[0] != '\0') {
                     char error_text[64];
-                    snprintf(error_text, sizeof(error_text), "%s\nNot Connected", hr_sensor_name);
+                    snprintf(error_text, sizeof(error_text), "%s\nNot Connected", ui_model.hr_name);
                     lv_label_set_text(lbl_hr_sensor_name, error_text);
                     lv_obj_set_style_translate_y(lbl_hr_sensor_name, 12, 0);
                 } else {
                     lv_label_set_text(lbl_hr_sensor_name, "Not Connected");
                 }
-            }
-            break;
-            
-        case HR_NOT_CONFIGURATED:
-            /* Not configured: Show disconnected icon and "Not Configured" */
-            if (lbl_hr_value) {
-                lv_obj_add_flag(lbl_hr_value, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (lbl_hr_heart) {
-                lv_obj_add_flag(lbl_hr_heart, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (lbl_hr_disconnected) {
-                lv_obj_clear_flag(lbl_hr_disconnected, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_set_style_translate_y(lbl_hr_disconnected, -2, 0);
-            }
-            lv_obj_set_style_translate_y(row_value, 0, 0);
-            if (lbl_hr_sensor_name) {
+                break;
+            case HR_NOT_CONFIGURATED:
                 lv_label_set_text(lbl_hr_sensor_name, "Not Configured");
                 lv_obj_set_style_translate_y(lbl_hr_sensor_name, 0, 0);
-            }
-            break;
+                break;
+        }
     }
-    
-    /* Update powersave screen if it exists */
-    update_powersave_display();
 }
 
 /* --- CSC Widget --- */
 static void create_csc_widget(lv_obj_t *parent)
 {
-    card_csc = lv_obj_create(parent);
-    lv_obj_set_size(card_csc, LV_PCT(100), 64);
+    card_csc = lv_obj_create(parent);  /* Geometry: ui_layout_apply() */
     lv_obj_set_style_radius(card_csc, RADIUS_WIDGET, 0);
     lv_obj_set_style_border_width(card_csc, 0, 0);
     lv_obj_set_style_pad_left(card_csc, 15, 0);
@@ -669,7 +791,7 @@ static void create_csc_widget(lv_obj_t *parent)
 
     /* Sensor Name Label */
     lbl_csc_sensor_name = lv_label_create(label_group);
-    lv_label_set_text(lbl_csc_sensor_name, csc_sensor_name);
+    lv_label_set_text(lbl_csc_sensor_name, ui_model.csc_name);
     lv_obj_set_style_text_color(lbl_csc_sensor_name, lv_color_white(), 0);
     lv_obj_set_style_text_font(lbl_csc_sensor_name, &lv_font_inter_bold_14, 0);
     lv_obj_set_style_translate_y(lbl_csc_sensor_name, 2, 0);
@@ -687,21 +809,27 @@ static void create_csc_widget(lv_obj_t *parent)
 static void update_csc_widget(void)
 {
     if (!card_csc) return;
-
-    if (should_skip_main_screen_update()) {
-        return;
-    }
-
-    /* O3: Use pre-defined styles instead of individual setter calls */
-    /* Cache previous state to avoid redundant style changes */
-    static csc_state_t prev_state = (csc_state_t)-1;
-    
-    if (csc_current_state != prev_state) {
-        /* Remove old style, add new style based on state */
+    if (!(main_view_dirty & UI_FIELDS_CSC)) return;
+    if (should_skip_main_screen_update()) return;
+    main_view_dirty &= ~UI_FIELDS_CSC;
+
+    /* Diff against what the widget shows right now */
+    bool shown = (main_shown_valid & UI_FIELDS_CSC) == UI_FIELDS_CSC;
+    bool state_changed = !shown || ui_model.csc_state != main_shown.csc_state;
+    bool cadence_changed = !shown || ui_model.csc_cadence != main_shown.csc_cadence;
+    bool name_changed = !shown || strcmp(ui_model.csc_name, main_shown.csc_name) != 0;
+
+    main_shown.csc_state = ui_model.csc_state;
+    main_shown.csc_cadence = ui_model.csc_cadence;
+    memcpy(main_shown.csc_name, ui_model.csc_name, sizeof(main_shown.csc_name));
+    main_shown_valid |= UI_FIELDS_CSC;
+
+    if (state_changed) {
+        /* O3: Use pre-defined styles instead of individual setter calls */
         lv_obj_remove_style(card_csc, &style_csc_active, 0);
         lv_obj_remove_style(card_csc, &style_csc_inactive, 0);
-        
-        switch (csc_current_state) {
+
+        switch (ui_model.csc_state) {
             case CSC_NOT_CONFIGURATED:
                 lv_obj_add_style(card_csc, &style_csc_inactive, 0);
                 break;
@@ -710,35 +838,32 @@ static void update_csc_widget(void)
                 lv_obj_add_style(card_csc, &style_csc_active, 0);
                 break;
         }
-        prev_state = csc_current_state;
-    }
 
-    /* Update icon group */
-    if (csc_current_state == CSC_STATE_ACTIVE) {
-        /* Active: Show checkmark icon (U+32), hide error icon */
-        lv_obj_set_style_bg_opa(csc_icon_group, LV_OPA_TRANSP, 0);
-        lv_obj_add_flag(csc_icon_label, LV_OBJ_FLAG_HIDDEN);
-        if (csc_checkmark_label) {
-            lv_obj_clear_flag(csc_checkmark_label, LV_OBJ_FLAG_HIDDEN);
-        }
-    } else {
-        /* Inactive/Error: Show white circle with error icon (U+33) */
-        lv_obj_set_style_bg_color(csc_icon_group, lv_color_white(), 0);
-        //lv_obj_set_style_bg_opa(csc_icon_group, LV_OPA_COVER, 0);
-       // lv_obj_clear_flag(csc_icon_label, LV_OBJ_FLAG_HIDDEN);
-        if (csc_checkmark_label) {
-            lv_obj_add_flag(csc_checkmark_label, LV_OBJ_FLAG_HIDDEN);
+        /* Update icon group */
+        if (ui_model.csc_state == CSC_STATE_ACTIVE) {
+            /* Active: Show checkmark icon (U+32), hide error icon */
+            lv_obj_set_style_bg_opa(csc_icon_group, LV_OPA_TRANSP, 0);
+            lv_obj_add_flag(csc_icon_label, LV_OBJ_FLAG_HIDDEN);
+            if (csc_checkmark_label) {
+                lv_obj_clear_flag(csc_checkmark_label, LV_OBJ_FLAG_HIDDEN);
+            }
+        } else {
+            /* Inactive/Error: Show white circle with error icon (U+33) */
+            lv_obj_set_style_bg_color(csc_icon_group, lv_color_white(), 0);
+            if (csc_checkmark_label) {
+                lv_obj_add_flag(csc_checkmark_label, LV_OBJ_FLAG_HIDDEN);
+            }
+            // Error icon color is already set to COLOR_CSC in create function
         }
-        // Error icon color is already set to COLOR_CSC in create function
     }
 
     /* Update labels */
-    if (lbl_csc_sensor_name) {
-        lv_label_set_text(lbl_csc_sensor_name, csc_sensor_name);
+    if (lbl_csc_sensor_name && name_changed) {
+        lv_label_set_text(lbl_csc_sensor_name, ui_model.csc_name);
     }
 
-    if (lbl_csc_status) {
-        switch (csc_current_state) {
+    if (lbl_csc_status && (state_changed || (cadence_changed && ui_model.csc_state == CSC_STATE_ACTIVE))) {
+        switch (ui_model.csc_state) {
             case CSC_NOT_CONFIGURATED:
                 lv_label_set_text(lbl_csc_status, "Not Configured");
                 break;
@@ -750,132 +875,294 @@ static void update_csc_widget(void)
                 break;
         }
     }
-    
-    /* Update powersave screen if it exists */
-    update_powersave_display();
 }
 
 /* --- Fan Widget --- */
 static void create_fan_widget(lv_obj_t *parent)
 {
+    /* Viewport: two rows visible, vertical scroll for more fans */
     fan_container = lv_obj_create(parent);
     apply_transparent_container_style(fan_container);
-    lv_obj_set_size(fan_container, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_flex_flow(fan_container, LV_FLEX_FLOW_ROW_WRAP);
-    lv_obj_set_flex_align(fan_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
-    lv_obj_set_style_pad_row(fan_container, 12, 0);
-    lv_obj_set_style_pad_column(fan_container, 12, 0);
-    lv_obj_clear_flag(fan_container, LV_OBJ_FLAG_SCROLLABLE);
-
-    /* Create 4 fan items (Figma: pill with circle + state text) */
-    for (uint8_t i = 0; i < MAX_FANS; i++) {
+    lv_obj_set_height(fan_container, FAN_VIEWPORT_H);
+    lv_obj_set_scroll_dir(fan_container, LV_DIR_VER);
+    lv_obj_set_scroll_snap_y(fan_container, LV_SCROLL_SNAP_START);
+    lv_obj_add_event_cb(fan_container, fan_list_scroll_event_cb, LV_EVENT_SCROLL, NULL);
+
+    /* Invisible 1px marker at the bottom of the last row defines the scroll range */
+    fan_list_spacer = lv_obj_create(fan_container);
+    apply_transparent_container_style(fan_list_spacer);
+    lv_obj_set_size(fan_list_spacer, 1, 1);
+    lv_obj_clear_flag(fan_list_spacer, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SNAPPABLE);
+
+    /* Pill pool (Figma: pill with circle + state text), bound to fans on demand */
+    for (uint8_t i = 0; i < FAN_POOL_SIZE; i++) {
         /* Pill-shaped card */
-        fan_items[i].card = lv_obj_create(fan_container);
-        lv_obj_set_size(fan_items[i].card, 133, 64);
-        lv_obj_set_style_radius(fan_items[i].card, RADIUS_WIDGET, 0);  /* Pill: radius = half height */
-        lv_obj_set_style_border_width(fan_items[i].card, 0, 0);
-        lv_obj_set_style_pad_left(fan_items[i].card, 14, 0);
-        lv_obj_set_style_pad_right(fan_items[i].card, 14, 0);
-        lv_obj_set_style_pad_top(fan_items[i].card, 12, 0);
-        lv_obj_set_style_pad_bottom(fan_items[i].card, 12, 0);
-        lv_obj_clear_flag(fan_items[i].card, LV_OBJ_FLAG_SCROLLABLE);
-        lv_obj_set_flex_flow(fan_items[i].card, LV_FLEX_FLOW_ROW);
-        lv_obj_set_flex_align(fan_items[i].card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-        lv_obj_set_style_pad_gap(fan_items[i].card, 2, 0);
+        fan_slots[i].card = lv_obj_create(fan_container);
+        lv_obj_set_size(fan_slots[i].card, fan_pill_w, FAN_PILL_H);
+        lv_obj_set_style_radius(fan_slots[i].card, RADIUS_WIDGET, 0);  /* Pill: radius = half height */
+        lv_obj_set_style_border_width(fan_slots[i].card, 0, 0);
+        lv_obj_set_style_pad_left(fan_slots[i].card, 14, 0);
+        lv_obj_set_style_pad_right(fan_slots[i].card, 14, 0);
+        lv_obj_set_style_pad_top(fan_slots[i].card, 12, 0);
+        lv_obj_set_style_pad_bottom(fan_slots[i].card, 12, 0);
+        lv_obj_clear_flag(fan_slots[i].card, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_flex_flow(fan_slots[i].card, LV_FLEX_FLOW_ROW);
+        lv_obj_set_flex_align(fan_slots[i].card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+        lv_obj_set_style_pad_gap(fan_slots[i].card, 2, 0);
 
         /* Circle only (no icon glyphs) – green for Inactive, white for Active */
-        fan_items[i].icon_group = lv_obj_create(fan_items[i].card);
-        lv_obj_set_size(fan_items[i].icon_group, 36, 36);
-        lv_obj_set_style_radius(fan_items[i].icon_group, RADIUS_ICON, 0);
-        lv_obj_set_style_border_width(fan_items[i].icon_group, 0, 0);
-        lv_obj_set_style_pad_all(fan_items[i].icon_group, 0, 0);
-        lv_obj_clear_flag(fan_items[i].icon_group, LV_OBJ_FLAG_SCROLLABLE);
-
-        /* State label: "Off", "On", or "Error" (set in update_fan_item); centered in remaining space */
-        fan_items[i].lbl_name = lv_label_create(fan_items[i].card);
-        lv_label_set_text(fan_items[i].lbl_name, "Off");
-        lv_obj_set_style_text_color(fan_items[i].lbl_name, lv_color_hex(COLOR_TEXT_DARK), 0);
-        lv_obj_set_style_text_font(fan_items[i].lbl_name, &lv_font_inter_bold_24, 0);
-        lv_obj_set_style_text_align(fan_items[i].lbl_name, LV_TEXT_ALIGN_CENTER, 0);
-        lv_obj_set_style_pad_top(fan_items[i].lbl_name, 2, 0);
-        lv_obj_set_flex_grow(fan_items[i].lbl_name, 1);  /* Take remaining width so text centers in pill */
-
-        lv_obj_add_event_cb(fan_items[i].card, fan_toggle_event_cb, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-
-        fan_items[i].state = FAN_STATE_NOT_CONFIGURATED;
-        fan_items[i].is_on = false;
-        update_fan_item(i);
+        fan_slots[i].icon_group = lv_obj_create(fan_slots[i].card);
+        lv_obj_set_size(fan_slots[i].icon_group, 36, 36);
+        lv_obj_set_style_radius(fan_slots[i].icon_group, RADIUS_ICON, 0);
+        lv_obj_set_style_border_width(fan_slots[i].icon_group, 0, 0);
+        lv_obj_set_style_pad_all(fan_slots[i].icon_group, 0, 0);
+        lv_obj_clear_flag(fan_slots[i].icon_group, LV_OBJ_FLAG_SCROLLABLE);
+
+        /* State label: "Off", "On", or "Error" (set in render_fan_slot); centered in remaining space */
+        fan_slots[i].lbl_name = lv_label_create(fan_slots[i].card);
+        lv_label_set_text(fan_slots[i].lbl_name, "Off");
+        lv_obj_set_style_text_color(fan_slots[i].lbl_name, lv_color_hex(COLOR_TEXT_DARK), 0);
+        lv_obj_set_style_text_font(fan_slots[i].lbl_name, &lv_font_inter_bold_24, 0);
+        lv_obj_set_style_text_align(fan_slots[i].lbl_name, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_set_style_pad_top(fan_slots[i].lbl_name, 2, 0);
+        lv_obj_set_flex_grow(fan_slots[i].lbl_name, 1);  /* Take remaining width so text centers in pill */
+
+        lv_obj_add_event_cb(fan_slots[i].card, fan_toggle_event_cb, LV_EVENT_CLICKED, (void*)(intptr_t)i);
+
+        fan_slots[i].fan = -1;
+        lv_obj_add_flag(fan_slots[i].card, LV_OBJ_FLAG_HIDDEN);
     }
 }
 
-static void update_fan_item(uint8_t index)
+/* --- Fan list layout: scroll range follows the runtime fan count --- */
+static void update_fan_list_layout(void)
 {
-    if (index >= MAX_FANS || !fan_items[index].card) return;
+    if (!fan_container) return;
+    if (!(main_view_dirty & UI_FIELD_FAN_COUNT)) return;
+    if (should_skip_main_screen_update()) return;
+    main_view_dirty &= ~UI_FIELD_FAN_COUNT;
+    fan_list_update_range();
+}
 
-    if (should_skip_main_screen_update()) {
-        return;
+/* --- Scroll range + bound window for the current fan count and column count --- */
+static void fan_list_update_range(void)
+{
+    uint8_t rows = (ui_model.fan_count + fan_columns - 1) / fan_columns;
+    lv_coord_t content_h = rows ? rows * FAN_ROW_PITCH - FAN_GAP : 0;
+    lv_obj_set_pos(fan_list_spacer, 0, content_h > 0 ? content_h - 1 : 0);
+
+    /* Fewer rows than before: keep the scroll position inside the new range */
+    lv_obj_update_layout(fan_container);
+    lv_coord_t max_scroll = content_h - lv_obj_get_content_height(fan_container);
+    if (max_scroll < 0) max_scroll = 0;
+    if (lv_obj_get_scroll_y(fan_container) > max_scroll) {
+        lv_obj_scroll_to_y(fan_container, max_scroll, LV_ANIM_OFF);
     }
+    fan_list_bind_window();
+}
 
-    /* O3: Skip update if state hasn't changed (reduces LVGL calls) */
-    if (fan_ui_cache[index].initialized &&
-        fan_ui_cache[index].state == fan_items[index].state &&
-        fan_ui_cache[index].is_on == fan_items[index].is_on) {
-        return;  /* No visual change needed */
+/* --- Bind pool slots to the fans in the visible row window --- */
+static void fan_list_bind_window(void)
+{
+    if (!fan_container) return;
+
+    lv_coord_t scroll_y = lv_obj_get_scroll_y(fan_container);
+    if (scroll_y < 0) scroll_y = 0;  /* Elastic overscroll at the top */
+    uint8_t first_row = (uint8_t)(scroll_y / FAN_ROW_PITCH);
+
+    int8_t wanted[FAN_POOL_SIZE];
+    for (uint8_t i = 0; i < FAN_POOL_SIZE; i++) {
+        wanted[i] = -1;
     }
-    
-    /* Update cache */
-    fan_ui_cache[index].state = fan_items[index].state;
-    fan_ui_cache[index].is_on = fan_items[index].is_on;
-    fan_ui_cache[index].initialized = true;
+    for (uint8_t r = 0; r < FAN_POOL_ROWS; r++) {
+        for (uint8_t c = 0; c < fan_columns; c++) {
+            uint16_t fan = (uint16_t)(first_row + r) * fan_columns + c;
+            if (fan < ui_model.fan_count) {
+                wanted[fan % FAN_POOL_SIZE] = (int8_t)fan;
+            }
+        }
+    }
+
+    for (uint8_t slot = 0; slot < FAN_POOL_SIZE; slot++) {
+        if (fan_slots[slot].fan == wanted[slot]) continue;  /* Still bound to the same fan */
+
+        /* Recycle: drop a running toggle animation of the previous fan */
+        lv_anim_del(&fan_anim_data[slot], (lv_anim_exec_xcb_t)fan_bg_color_anim_cb);
+        fan_anim_data[slot].obj = NULL;
+
+        fan_slots[slot].fan = wanted[slot];
+        fan_slots[slot].shown_valid = false;
+        if (wanted[slot] < 0) {
+            lv_obj_add_flag(fan_slots[slot].card, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+        uint8_t fan = (uint8_t)wanted[slot];
+        lv_obj_set_pos(fan_slots[slot].card,
+                       (fan % fan_columns) * (fan_pill_w + FAN_GAP),
+                       (fan / fan_columns) * FAN_ROW_PITCH);
+        lv_obj_clear_flag(fan_slots[slot].card, LV_OBJ_FLAG_HIDDEN);
+        render_fan_slot(slot);
+    }
+}
+
+static void fan_list_scroll_event_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    fan_list_bind_window();
+}
+
+static void update_fan_item(uint8_t index)
+{
+    if (index >= HOMEWIND_MAX_FANS) return;
+    if (!(main_view_dirty & UI_FIELD_FAN(index))) return;
+    if (should_skip_main_screen_update()) return;
+    main_view_dirty &= ~UI_FIELD_FAN(index);
+
+    /* Off-screen fans have no pill; they are drawn when scrolled into view */
+    uint8_t slot = index % FAN_POOL_SIZE;
+    if (fan_slots[slot].fan == (int8_t)index) {
+        render_fan_slot(slot);
+    }
+}
+
+static void render_fan_slot(uint8_t slot)
+{
+    uint8_t index = (uint8_t)fan_slots[slot].fan;
+
+    /* O3: Skip update if the pill already shows this state (reduces LVGL calls) */
+    if (fan_slots[slot].shown_valid &&
+        fan_slots[slot].shown_state == ui_model.fan_state[index] &&
+        fan_slots[slot].shown_on == ui_model.fan_on[index]) {
+        return;
+    }
+    fan_slots[slot].shown_state = ui_model.fan_state[index];
+    fan_slots[slot].shown_on = ui_model.fan_on[index];
+    fan_slots[slot].shown_valid = true;
 
-    switch (fan_items[index].state) {
+    switch (ui_model.fan_state[index]) {
         case FAN_STATE_NOT_CONFIGURATED: {
             /* Figma: light gray pill, no circle, no text */
-            lv_obj_set_style_bg_color(fan_items[index].card, lv_color_hex(COLOR_FAN_UNCONFIGURED), 0);
-            lv_obj_set_style_bg_opa(fan_items[index].card, LV_OPA_COVER, 0);
-            lv_obj_add_flag(fan_items[index].icon_group, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(fan_items[index].lbl_name, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_set_style_bg_color(fan_slots[slot].card, lv_color_hex(COLOR_FAN_UNCONFIGURED), 0);
+            lv_obj_set_style_bg_opa(fan_slots[slot].card, LV_OPA_COVER, 0);
+            lv_obj_add_flag(fan_slots[slot].icon_group, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_add_flag(fan_slots[slot].lbl_name, LV_OBJ_FLAG_HIDDEN);
             break;
         }
         case FAN_STATE_ACTIVE:
             /* ACTIVE: label left, circle right */
-            lv_obj_move_foreground(fan_items[index].icon_group);
-            if (fan_items[index].is_on) {
-                lv_obj_clear_flag(fan_items[index].icon_group, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_clear_flag(fan_items[index].lbl_name, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_set_style_bg_color(fan_items[index].card, lv_color_hex(COLOR_FAN_ACTIVE_ON), 0);
-                lv_obj_set_style_bg_opa(fan_items[index].card, LV_OPA_COVER, 0);
-                lv_obj_set_style_bg_color(fan_items[index].icon_group, lv_color_white(), 0);
-                lv_obj_set_style_bg_opa(fan_items[index].icon_group, LV_OPA_COVER, 0);
-                lv_label_set_text(fan_items[index].lbl_name, "On");
-                lv_obj_set_style_text_color(fan_items[index].lbl_name, lv_color_white(), 0);
+            lv_obj_move_foreground(fan_slots[slot].icon_group);
+            if (ui_model.fan_on[index]) {
+                lv_obj_clear_flag(fan_slots[slot].icon_group, LV_OBJ_FLAG_HIDDEN);
+                lv_obj_clear_flag(fan_slots[slot].lbl_name, LV_OBJ_FLAG_HIDDEN);
+                lv_obj_set_style_bg_color(fan_slots[slot].card, lv_color_hex(COLOR_FAN_ACTIVE_ON), 0);
+                lv_obj_set_style_bg_opa(fan_slots[slot].card, LV_OPA_COVER, 0);
+                lv_obj_set_style_bg_color(fan_slots[slot].icon_group, lv_color_white(), 0);
+                lv_obj_set_style_bg_opa(fan_slots[slot].icon_group, LV_OPA_COVER, 0);
+                lv_label_set_text(fan_slots[slot].lbl_name, "On");
+                lv_obj_set_style_text_color(fan_slots[slot].lbl_name, lv_color_white(), 0);
                 break;
             }
             /* ACTIVE with is_on=false: same look as INACTIVE */
         case FAN_STATE_INACTIVE:
             /* INACTIVE: label right, circle left */
-            lv_obj_move_foreground(fan_items[index].lbl_name);
-            lv_obj_set_style_bg_color(fan_items[index].card, lv_color_hex(COLOR_WHITE), 0);
-            lv_obj_set_style_bg_opa(fan_items[index].card, LV_OPA_COVER, 0);
-            lv_obj_clear_flag(fan_items[index].icon_group, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(fan_items[index].lbl_name, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_set_style_bg_color(fan_items[index].icon_group, lv_color_hex(COLOR_SUCCESS_ICON), 0);
-            lv_obj_set_style_bg_opa(fan_items[index].icon_group, LV_OPA_COVER, 0);
-            lv_label_set_text(fan_items[index].lbl_name, "Off");
-            lv_obj_set_style_text_color(fan_items[index].lbl_name, lv_color_hex(COLOR_TEXT_DARK), 0);
+            lv_obj_move_foreground(fan_slots[slot].lbl_name);
+            lv_obj_set_style_bg_color(fan_slots[slot].card, lv_color_hex(COLOR_WHITE), 0);
+            lv_obj_set_style_bg_opa(fan_slots[slot].card, LV_OPA_COVER, 0);
+            lv_obj_clear_flag(fan_slots[slot].icon_group, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_clear_flag(fan_slots[slot].lbl_name, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_set_style_bg_color(fan_slots[slot].icon_group, lv_color_hex(COLOR_SUCCESS_ICON), 0);
+            lv_obj_set_style_bg_opa(fan_slots[slot].icon_group, LV_OPA_COVER, 0);
+            lv_label_set_text(fan_slots[slot].lbl_name, "Off");
+            lv_obj_set_style_text_color(fan_slots[slot].lbl_name, lv_color_hex(COLOR_TEXT_DARK), 0);
             break;
         case FAN_STATE_ERROR:
-            lv_obj_add_flag(fan_items[index].icon_group, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(fan_items[index].lbl_name, LV_OBJ_FLAG_HIDDEN);
-            lv_label_set_text(fan_items[index].lbl_name, "Error");
-            lv_obj_set_style_bg_color(fan_items[index].card, lv_color_hex(COLOR_ACCENT), 0);
-            lv_obj_set_style_bg_opa(fan_items[index].card, LV_OPA_COVER, 0);
-            lv_obj_set_style_text_color(fan_items[index].lbl_name, lv_color_white(), 0);
+            lv_obj_add_flag(fan_slots[slot].icon_group, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_clear_flag(fan_slots[slot].lbl_name, LV_OBJ_FLAG_HIDDEN);
+            lv_label_set_text(fan_slots[slot].lbl_name, "Error");
+            lv_obj_set_style_bg_color(fan_slots[slot].card, lv_color_hex(COLOR_ACCENT), 0);
+            lv_obj_set_style_bg_opa(fan_slots[slot].card, LV_OPA_COVER, 0);
+            lv_obj_set_style_text_color(fan_slots[slot].lbl_name, lv_color_white(), 0);
             break;
     }
-    
-    /* Update powersave screen if it exists */
-    update_powersave_display();
+}
+
+/* --- Render all pending main view fields (no-op while the view is hidden) --- */
+static void render_main_view(void)
+{
+    update_hr_widget();
+    update_csc_widget();
+    update_fan_list_layout();
+    for (uint8_t i = 0; i < HOMEWIND_MAX_FANS; i++) {
+        update_fan_item(i);
+    }
+}
+
+/* --- QR Code Widget --- */
+static void qr_code_encode_if_dirty(void)
+{
+    if (!qr_code_dirty) return;
+    qr_code_dirty = false;
+
+    bool ok = qrcodegen_encodeText(qr_code_url, qr_encode_tmp, qr_modules,
+                                   qrcodegen_Ecc_MEDIUM, qrcodegen_VERSION_MIN,
+                                   QR_CODE_MAX_VERSION, qrcodegen_Mask_AUTO, true);
+    qr_module_count = ok ? qrcodegen_getSize(qr_modules) : 0;
+    if (qr_code_widget) {
+        lv_obj_invalidate(qr_code_widget);
+    }
+}
+
+/* Draws the module matrix scaled to the widget size. Dark modules are merged
+ * into horizontal runs and only rows inside the current clip area are drawn,
+ * so a partial flush band costs a handful of rect fills. No encoding here:
+ * it invalidates the widget, which LVGL rejects while rendering; the overlay
+ * open and the URL apply encode before the widget is drawn. */
+static void qr_code_draw_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+
+    int n = qr_module_count;
+    if (n <= 0) return;
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    lv_coord_t size = lv_area_get_width(&coords);
+    if (lv_area_get_height(&coords) < size) size = lv_area_get_height(&coords);
+    lv_coord_t scale = size / n;
+    if (scale < 1) return;
+    lv_coord_t x0 = coords.x1 + (lv_area_get_width(&coords) - scale * n) / 2;
+    lv_coord_t y0 = coords.y1 + (lv_area_get_height(&coords) - scale * n) / 2;
+
+    /* Restrict to module rows intersecting the clip area */
+    const lv_area_t *clip = draw_ctx->clip_area;
+    if (clip->y2 < y0 || clip->y1 >= y0 + scale * n) return;
+    int row_first = (clip->y1 - y0) / scale;
+    int row_last = (clip->y2 - y0) / scale;
+    if (clip->y1 < y0) row_first = 0;
+    if (row_last >= n) row_last = n - 1;
+    if (row_last < row_first) return;
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_color = lv_color_white();
+    dsc.bg_opa = LV_OPA_COVER;
+    dsc.radius = 0;
+
+    lv_area_t run;
+    for (int y = row_first; y <= row_last; y++) {
+        run.y1 = y0 + y * scale;
+        run.y2 = run.y1 + scale - 1;
+        int x = 0;
+        while (x < n) {
+            if (!qrcodegen_getModule(qr_modules, x, y)) { x++; continue; }
+            int start = x;
+            while (x < n && qrcodegen_getModule(qr_modules, x, y)) x++;
+            run.x1 = x0 + start * scale;
+            run.x2 = x0 + x * scale - 1;
+            lv_draw_rect(draw_ctx, &dsc, &run);
+        }
+    }
 }
 
 /* --- Settings Modal --- */
@@ -896,11 +1183,8 @@ static void create_settings_modal(void)
     lv_obj_set_y(settings_overlay, h + 6);  // Position off-screen, accounting for -6 offset
     lv_obj_add_flag(settings_overlay, LV_OBJ_FLAG_HIDDEN);
 
-    /* QR Code Card */
+    /* QR Code Card (geometry: ui_layout_apply()) */
     settings_card = lv_obj_create(settings_overlay);
-    lv_coord_t card_w = w - 2;
-    lv_coord_t card_h = h - 130;
-    lv_obj_set_size(settings_card, card_w, card_h);
     lv_obj_set_style_radius(settings_card, RADIUS_CARD, 0);
     lv_obj_set_style_bg_color(settings_card, lv_color_hex(COLOR_MODAL_CARD), 0);
     lv_obj_set_style_bg_opa(settings_card, LV_OPA_COVER, 0);
@@ -909,13 +1193,13 @@ static void create_settings_modal(void)
     lv_obj_set_style_pad_bottom(settings_card, 0, 0);
     lv_obj_set_style_pad_hor(settings_card, 12, 0);
     lv_obj_clear_flag(settings_card, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_align(settings_card, LV_ALIGN_TOP_MID, 0, 0);  // Moved 4px higher (was 12)
 
-    /* QR Code Widget */
-    lv_coord_t qr_size = card_w - 20;
-    if (qr_size > 220) qr_size = 220;
-    qr_code_widget = lv_qrcode_create(settings_card, qr_size, lv_color_white(), lv_color_hex(COLOR_MODAL_CARD));
-    lv_qrcode_update(qr_code_widget, qr_code_url, strlen(qr_code_url));
+    /* QR Code Widget (plain object, modules drawn in qr_code_draw_event_cb) */
+    qr_code_widget = lv_obj_create(settings_card);
+    apply_transparent_container_style(qr_code_widget);
+    lv_obj_clear_flag(qr_code_widget, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(qr_code_widget, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(qr_code_widget, qr_code_draw_event_cb, LV_EVENT_DRAW_MAIN, NULL);
     lv_obj_align(qr_code_widget, LV_ALIGN_TOP_MID, 0, 10);
 
     /* Text Label */
@@ -929,16 +1213,12 @@ static void create_settings_modal(void)
     lv_obj_align(lbl_scan, LV_ALIGN_BOTTOM_MID, 0, -8);
 
     /* Close Button */
-    lv_obj_t *btn_close = lv_btn_create(settings_overlay);
-    lv_coord_t btn_w = w - 2;
-    if (btn_w < 140) btn_w = 140;
-    lv_obj_set_size(btn_close, btn_w, 72);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, 0);  // Moved 8px lower (was -12)
-    lv_obj_set_style_bg_color(btn_close, lv_color_hex(COLOR_ACCENT), 0);
-    lv_obj_set_style_radius(btn_close, RADIUS_BUTTON, 0);
-    lv_obj_add_event_cb(btn_close, close_btn_event_cb, LV_EVENT_CLICKED, NULL);
-
-    lv_obj_t *lbl_close = lv_label_create(btn_close);
+    btn_modal_close = lv_btn_create(settings_overlay);
+    lv_obj_set_style_bg_color(btn_modal_close, lv_color_hex(COLOR_ACCENT), 0);
+    lv_obj_set_style_radius(btn_modal_close, RADIUS_BUTTON, 0);
+    lv_obj_add_event_cb(btn_modal_close, close_btn_event_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *lbl_close = lv_label_create(btn_modal_close);
     lv_label_set_text(lbl_close, "Close");
     lv_obj_set_style_text_font(lbl_close, &lv_font_inter_bold_24, 0);
     lv_obj_center(lbl_close);
@@ -1039,28 +1319,14 @@ static void create_main_screen(void)
     lv_obj_set_style_bg_color(scr_main, lv_color_hex(COLOR_BG_APP), 0);
     lv_obj_set_style_bg_opa(scr_main, LV_OPA_COVER, 0);
 
-    /* Stack Container */
-    lv_obj_t *stack = lv_obj_create(scr_main);
-    apply_transparent_container_style(stack);
-    lv_obj_set_style_pad_row(stack, 12, 0);
-    lv_obj_set_style_pad_column(stack, 0, 0);
-    lv_coord_t stack_h = h - 72 - 10;  /* keep 10px gap to Settings button (4px more space for content) */
-    if (stack_h < 0) stack_h = 0;
-    lv_obj_set_size(stack, w - 2, stack_h);
-    lv_obj_align(stack, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_flex_flow(stack, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(stack, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
-    lv_obj_clear_flag(stack, LV_OBJ_FLAG_SCROLLABLE);
-
-    /* Create Widgets */
-    create_hr_widget(stack);
-    create_csc_widget(stack);
-    create_fan_widget(stack);
+    /* Create Widgets (placed by ui_layout_apply(), no flex stack: the
+     * landscape layout uses two columns) */
+    create_hr_widget(scr_main);
+    create_csc_widget(scr_main);
+    create_fan_widget(scr_main);
 
     /* Settings Button */
-    lv_obj_t *btn_settings = lv_btn_create(scr_main);
-    lv_obj_set_size(btn_settings, w - 2, 72);
-    lv_obj_align(btn_settings, LV_ALIGN_BOTTOM_MID, 0, 0);
+    btn_settings = lv_btn_create(scr_main);
     lv_obj_set_style_bg_color(btn_settings, lv_color_hex(COLOR_ACCENT), 0);
     lv_obj_set_style_radius(btn_settings, RADIUS_BUTTON, 0);
     lv_obj_add_event_cb(btn_settings, settings_btn_event_cb, LV_EVENT_CLICKED, NULL);
@@ -1071,17 +1337,134 @@ static void create_main_screen(void)
     lv_obj_center(lbl_settings);
     lv_obj_set_style_translate_y(lbl_settings, 2, 0);
 
+    /* History Panel (swipe left), below the settings modal */
+    history_create_panel(scr_main);
+
     /* Create Settings Modal */
     create_settings_modal();
+
+    /* Both orientations are computed once; rotations only apply them */
+    lv_coord_t phys_w = w < h ? w : h;
+    lv_coord_t phys_h = w < h ? h : w;
+    ui_layout_compute(&ui_layouts[UI_LAYOUT_PORTRAIT], phys_w, phys_h);
+    ui_layout_compute(&ui_layouts[UI_LAYOUT_LANDSCAPE], phys_h, phys_w);
+    ui_layout_apply(w > h ? UI_LAYOUT_LANDSCAPE : UI_LAYOUT_PORTRAIT);
+}
+
+/* --- Orientation Layouts --- */
+static void ui_rect_apply(lv_obj_t *obj, const ui_rect_t *r)
+{
+    lv_obj_set_size(obj, r->w, r->h);
+    lv_obj_align(obj, r->align, r->x, r->y);
+}
+
+/* w/h: screen size in this orientation. Needs the settings modal (theme padding). */
+static void ui_layout_compute(ui_layout_t *l, lv_coord_t w, lv_coord_t h)
+{
+    lv_coord_t cw = w - 2;  /* 1 px margin left and right */
+    lv_coord_t modal_pad = lv_obj_get_style_pad_top(settings_overlay, LV_PART_MAIN) +
+                           lv_obj_get_style_pad_bottom(settings_overlay, LV_PART_MAIN);
+
+    if (h >= w) {
+        /* Portrait: HR / CSC / fans stacked, Settings across the bottom */
+        l->hr = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, 0, cw, HR_CARD_H };
+        l->csc = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, HR_CARD_H + STACK_GAP, cw, CSC_CARD_H };
+        l->fans = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, HR_CARD_H + CSC_CARD_H + 2 * STACK_GAP, cw, FAN_VIEWPORT_H };
+        l->settings_btn = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, h - BUTTON_H, cw, BUTTON_H };
+        l->fan_columns = 2;
+        l->fan_pill_w = (cw - FAN_GAP) / 2;
+        l->modal_card = (ui_rect_t){ LV_ALIGN_TOP_MID, 0, 0, cw, h - 130 };
+        l->modal_close = (ui_rect_t){ LV_ALIGN_BOTTOM_MID, 0, 0, cw < 140 ? 140 : cw, BUTTON_H };
+    } else {
+        /* Landscape: HR over CSC on the left, fans (one column) over Settings on the right */
+        lv_coord_t right_x = 1 + LANDSCAPE_LEFT_W + STACK_GAP;
+        lv_coord_t right_w = w - 1 - right_x;
+        lv_coord_t hr_h = h - STACK_GAP - CSC_CARD_H;
+        l->hr = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, 0, LANDSCAPE_LEFT_W, hr_h };
+        l->csc = (ui_rect_t){ LV_ALIGN_TOP_LEFT, 1, hr_h + STACK_GAP, LANDSCAPE_LEFT_W, CSC_CARD_H };
+        l->fans = (ui_rect_t){ LV_ALIGN_TOP_LEFT, right_x, 0, right_w, FAN_VIEWPORT_H };
+        l->settings_btn = (ui_rect_t){ LV_ALIGN_TOP_LEFT, right_x, h - BUTTON_H, right_w, BUTTON_H };
+        l->fan_columns = 1;
+        l->fan_pill_w = right_w;
+        /* Modal: same columns; x offsets are from the overlay centre (= screen centre) */
+        l->modal_card = (ui_rect_t){ LV_ALIGN_TOP_MID, 1 + LANDSCAPE_LEFT_W / 2 - w / 2, 0,
+                                     LANDSCAPE_LEFT_W, h + 6 - modal_pad };
+        l->modal_close = (ui_rect_t){ LV_ALIGN_BOTTOM_MID, right_x + right_w / 2 - w / 2, 0,
+                                      right_w, BUTTON_H };
+    }
+
+    lv_coord_t qr = l->modal_card.w - 20;
+    if (qr > l->modal_card.h - MODAL_QR_TEXT_RESERVE) qr = l->modal_card.h - MODAL_QR_TEXT_RESERVE;
+    if (qr > QR_CODE_MAX_SIZE_PX) qr = QR_CODE_MAX_SIZE_PX;
+    l->qr_size = qr;
+}
+
+/* Copy a cached layout onto the main screen objects (LVGL context) */
+static void ui_layout_apply(ui_layout_id_t id)
+{
+    const ui_layout_t *l = &ui_layouts[id];
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_coord_t w = lv_disp_get_hor_res(disp);
+    lv_coord_t h = lv_disp_get_ver_res(disp);
+
+    ui_layout_current = id;
+    ui_rect_apply(card_hr, &l->hr);
+    ui_rect_apply(card_csc, &l->csc);
+    ui_rect_apply(fan_container, &l->fans);
+    ui_rect_apply(btn_settings, &l->settings_btn);
+
+    /* Fan pills: new width / column count, rebind the window from the top */
+    fan_columns = l->fan_columns;
+    fan_pill_w = l->fan_pill_w;
+    for (uint8_t i = 0; i < FAN_POOL_SIZE; i++) {
+        lv_obj_set_width(fan_slots[i].card, fan_pill_w);
+        fan_slots[i].fan = -1;
+        lv_obj_add_flag(fan_slots[i].card, LV_OBJ_FLAG_HIDDEN);
+    }
+    lv_obj_scroll_to_y(fan_container, 0, LV_ANIM_OFF);
+    fan_list_update_range();
+
+    /* Settings modal: full-screen overlay, kept off-screen while closed */
+    lv_obj_set_size(settings_overlay, w + 4, h + 6);
+    if (!settings_modal_visible) {
+        lv_obj_set_y(settings_overlay, h + 6);
+    }
+    ui_rect_apply(settings_card, &l->modal_card);
+    ui_rect_apply(btn_modal_close, &l->modal_close);
+    lv_obj_set_size(qr_code_widget, l->qr_size, l->qr_size);
+    lv_obj_align(qr_code_widget, LV_ALIGN_TOP_MID, 0, 10);
+
+    history_apply_layout(id == UI_LAYOUT_LANDSCAPE);
+}
+
+/* lcd_set_rotation() hook (LVGL mutex held); screens already have the new size */
+static void ui_layout_rotation_cb(lv_disp_rot_t rotation)
+{
+    if (!scr_main) return;
+    bool landscape = (rotation == LV_DISP_ROT_90 || rotation == LV_DISP_ROT_270);
+    ui_layout_id_t id = landscape ? UI_LAYOUT_LANDSCAPE : UI_LAYOUT_PORTRAIT;
+    if (id != ui_layout_current) {
+        ui_layout_apply(id);
+    }
 }
 
 /* --- Public API --- */
 void homewind_create_screens(void)
 {
+    mem_stats_lvgl_begin();
     create_boot_screen();
     create_ap_screen();
     create_main_screen();
     lv_scr_load(scr_boot);
+    mem_stats_lvgl_end(HOMEWIND_MEM_SCREENS);
+    mem_stats_account(HOMEWIND_MEM_QR, sizeof(qr_modules) + sizeof(qr_encode_tmp));
+    mem_stats_start();
+
+    /* Setters post into the state mailbox; the LVGL task applies it each frame */
+    refresh_timer = lv_timer_create(refresh_timer_cb, 1000, NULL);
+    lv_timer_pause(refresh_timer);  // Deadline for held values: never deferred on overruns
+    lcd_lvgl_set_frame_hook(ui_frame_hook);
+    lcd_set_rotation_callback(ui_layout_rotation_cb);
 
     // NOTE: powersave_init() is now called separately by homewind_init()
     // powersave starts with powersave_locked=true (Boot screen active)
@@ -1109,128 +1492,322 @@ void homewind_refresh_powersave_display(void)
 
 void homewind_refresh_main_display(void)
 {
-    /* Invalidate all widget caches to force full re-render */
-    hr_widget_cache_initialized = false;
-    
-    /* CSC widget uses a function-local static prev_state; we trigger a full
-       update by temporarily marking it as uninitialized via a state change.
-       The simplest approach: just call update_csc_widget() — the label/icon
-       setters are idempotent, and the cost is negligible on wake. */
-    
-    for (uint8_t i = 0; i < MAX_FANS; i++) {
-        fan_ui_cache[i].initialized = false;
+    /* Only fields that changed while the main screen was hidden are redrawn */
+    render_main_view();
+}
+
+/* ============================================================================
+ * State Mailbox Apply (LVGL task, once per frame)
+ * ============================================================================
+ * The homewind_set_* setters below never touch LVGL: they write into the
+ * ui_state mailbox and raise dirty bits. Here the LVGL task copies whatever
+ * changed since the last frame into the widget state and re-renders once,
+ * so a burst of BLE notifications costs a single UI update.
+ * ============================================================================ */
+
+static void ui_publish(uint32_t fields, const void *task)
+{
+    event_trace_instant(HOMEWIND_TRACE_SETTER, fields);
+    /* Wake the LVGL task only on the first change since its last apply
+     * (or on any change while it is suspended in the panel-off tier) */
+    bool first = ui_state_publish(fields, task);
+    if (lcd_lvgl_is_suspended()) {
+        /* Panel off and lying face down: nobody sees new data; the first update after it is lifted wakes the panel */
+        if (fields && !imu_fusion_is_face_down()) lcd_lvgl_wake();
+    } else if (first) {
+        lcd_lvgl_wake();
     }
-    
-    /* Re-render all widgets with current in-memory values */
-    update_hr_widget();
-    update_csc_widget();
-    for (uint8_t i = 0; i < MAX_FANS; i++) {
-        if (fan_items[i].card) {
-            update_fan_item(i);
+}
+
+/* Value fields that must wait (refresh cap / touch in progress); arms refresh_timer */
+static uint32_t refresh_hold(uint32_t dirty)
+{
+    uint32_t now = lv_tick_get();
+    bool touching = lcd_touch_is_pressed();
+    uint32_t hold = 0;
+    uint32_t wait_ms = UINT32_MAX;
+
+    for (uint8_t w = 0; w < HOMEWIND_WIDGET_COUNT; w++) {
+        widget_refresh_t *r = &widget_refresh[w];
+        uint32_t fields = dirty & r->value_fields;
+        if (!fields) continue;
+        if (dirty & r->widget_fields & ~r->value_fields) continue;  /* State/name change: render now */
+
+        uint32_t elapsed = now - r->last_apply_ms;
+        uint32_t remaining = 0;
+        if (r->interval_ms && elapsed < r->interval_ms) {
+            remaining = r->interval_ms - elapsed;
+        } else if (touching && r->priority == HOMEWIND_REFRESH_NORMAL &&
+                   elapsed < REFRESH_TOUCH_MAX_HOLD_MS) {
+            remaining = REFRESH_TOUCH_RECHECK_MS;
+        }
+        if (remaining) {
+            hold |= fields;
+            if (remaining < wait_ms) wait_ms = remaining;
+        }
+    }
+
+    if (hold && refresh_timer) {
+        lv_timer_set_period(refresh_timer, wait_ms);
+        lv_timer_reset(refresh_timer);
+        lv_timer_resume(refresh_timer);
+    }
+    return hold;
+}
+
+static void refresh_timer_cb(lv_timer_t *timer)
+{
+    lv_timer_pause(timer);
+    homewind_apply_pending();
+}
+
+static void homewind_apply_pending(void)
+{
+    uint32_t dirty = ui_state_take_dirty();
+    if (!dirty) return;
+    event_trace_begin(HOMEWIND_TRACE_UI_APPLY, dirty);
+    uint32_t retry = refresh_hold(dirty);  /* Held values + strings caught mid-write: apply later */
+    uint32_t changed = 0;                  /* Fields whose model value really differs */
+    dirty &= ~retry;
+
+    if (dirty & UI_FIELDS_HR) {
+        hr_state_t state = ui_state_get_hr_state();
+        uint16_t value = ui_state_get_hr_value();
+        if (state != ui_model.hr_state) { ui_model.hr_state = state; changed |= UI_FIELD_HR_STATE; }
+        if (value != ui_model.hr_value) { ui_model.hr_value = value; changed |= UI_FIELD_HR_VALUE; }
+        if (dirty & UI_FIELD_HR_NAME) {
+            char name[sizeof(ui_model.hr_name)];
+            if (!ui_state_copy_hr_name(name, sizeof(name))) {
+                retry |= UI_FIELD_HR_NAME;
+            } else if (strcmp(name, ui_model.hr_name) != 0) {
+                memcpy(ui_model.hr_name, name, sizeof(ui_model.hr_name));
+                changed |= UI_FIELD_HR_NAME;
+            }
+        }
+    }
+
+    if (dirty & UI_FIELDS_CSC) {
+        csc_state_t state = ui_state_get_csc_state();
+        uint16_t cadence = ui_state_get_csc_cadence();
+        if (state != ui_model.csc_state) { ui_model.csc_state = state; changed |= UI_FIELD_CSC_STATE; }
+        if (cadence != ui_model.csc_cadence) { ui_model.csc_cadence = cadence; changed |= UI_FIELD_CSC_CADENCE; }
+        if (dirty & UI_FIELD_CSC_NAME) {
+            char name[sizeof(ui_model.csc_name)];
+            if (!ui_state_copy_csc_name(name, sizeof(name))) {
+                retry |= UI_FIELD_CSC_NAME;
+            } else if (strcmp(name, ui_model.csc_name) != 0) {
+                memcpy(ui_model.csc_name, name, sizeof(ui_model.csc_name));
+                changed |= UI_FIELD_CSC_NAME;
+            }
+        }
+    }
+
+    uint32_t anim = 0;
+    if (dirty & UI_FIELD_FANS_ALL) {
+        anim = ui_state_take_fan_anim((dirty & UI_FIELD_FANS_ALL) >> UI_FIELD_FAN_SHIFT);
+        for (uint8_t i = 0; i < HOMEWIND_MAX_FANS; i++) {
+            if (!(dirty & UI_FIELD_FAN(i))) continue;
+            fan_state_t state = ui_state_get_fan_state(i);
+            bool is_on = ui_state_get_fan_on(i);
+            if (state != ui_model.fan_state[i] || is_on != ui_model.fan_on[i]) {
+                model_set_fan(i, state, is_on);
+                changed |= UI_FIELD_FAN(i);
+            }
+        }
+    }
+
+    if (dirty & UI_FIELD_FAN_COUNT) {
+        uint8_t count = ui_state_get_fan_count();
+        if (count != ui_model.fan_count) {
+            model_set_fan_count(count);
+            changed |= UI_FIELD_FAN_COUNT;
+        }
+    }
+
+    if (dirty & UI_FIELD_QR_URL) {
+        char url[sizeof(qr_code_url)];
+        if (ui_state_copy_qr_url(url, sizeof(url))) {
+            memcpy(qr_code_url, url, sizeof(qr_code_url));
+            /* Re-encode lazily; if the modal is open, encode now so it redraws */
+            qr_code_dirty = true;
+            if (settings_modal_visible) {
+                qr_code_encode_if_dirty();
+            }
+        } else {
+            retry |= UI_FIELD_QR_URL;
         }
     }
+
+    uint32_t now = lv_tick_get();
+    for (uint8_t w = 0; w < HOMEWIND_WIDGET_COUNT; w++) {
+        if (changed & widget_refresh[w].value_fields) {
+            widget_refresh[w].last_apply_ms = now;
+        }
+    }
+
+    if (changed & UI_FIELDS_HR) {
+        history_feed_hr(ui_model.hr_state, ui_model.hr_value);
+    }
+    if (changed & UI_FIELDS_CSC) {
+        history_feed_cadence(ui_model.csc_state, ui_model.csc_cadence);
+    }
+
+    /* One pass per view: main screen diff, then a single powersave recount */
+    if (changed) {
+        main_view_dirty |= changed;
+        render_main_view();
+        for (uint8_t i = 0; i < HOMEWIND_MAX_FANS; i++) {
+            if ((anim & (1u << i)) && (changed & UI_FIELD_FAN(i))) {
+                animate_fan_toggle(i);
+            }
+        }
+        update_powersave_display();
+    }
+
+    if (retry) {
+        ui_state_publish(retry, xTaskGetCurrentTaskHandle());
+    }
+    event_trace_end(HOMEWIND_TRACE_UI_APPLY, changed);
+}
+
+static void ui_frame_hook(void)
+{
+    homewind_apply_pending();
+    history_apply_config();
+    /* Main screen shown by any path (lv_scr_load, wake, modal close):
+     * catch up on fields that changed while it was hidden */
+    if (main_view_dirty) {
+        render_main_view();
+    }
 }
 
 /* ============================================================================
- * HR Widget API Implementation (with Change-Guards - O1 optimization)
+ * HR Widget API Implementation (mailbox, thread-safe)
  * ============================================================================ */
 
 void homewind_set_hr(hr_state_t state, const char* sensor_name, uint16_t value)
 {
-    bool changed = false;
-    if (state != hr_current_state) { hr_current_state = state; changed = true; }
-    if (sensor_name && strcmp(sensor_name, hr_sensor_name) != 0) {
-        strncpy(hr_sensor_name, sensor_name, sizeof(hr_sensor_name) - 1);
-        hr_sensor_name[sizeof(hr_sensor_name) - 1] = '\0';
-        changed = true;
-    }
-    if (value != hr_value) { hr_value = value; changed = true; }
-    if (changed) update_hr_widget();
+    const void *self = xTaskGetCurrentTaskHandle();
+    /* Smooth before the mailbox: unchanged output raises no dirty bit */
+    if (state != HR_STATE_ACTIVE) sensor_filter_reset(HOMEWIND_METRIC_HR);
+    ui_publish(ui_state_set_hr_state(state, self) |
+               ui_state_set_hr_name(sensor_name, self) |
+               ui_state_set_hr_value(sensor_filter_update(HOMEWIND_METRIC_HR, value), self), self);
 }
 
 void homewind_set_hr_state(hr_state_t state)
 {
-    if (state != hr_current_state) {
-        hr_current_state = state;
-        update_hr_widget();
-    }
+    const void *self = xTaskGetCurrentTaskHandle();
+    if (state != HR_STATE_ACTIVE) sensor_filter_reset(HOMEWIND_METRIC_HR);
+    ui_publish(ui_state_set_hr_state(state, self), self);
 }
 
 void homewind_set_hr_value(uint16_t value)
 {
-    if (value != hr_value) {
-        hr_value = value;
-        update_hr_widget();
-    }
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_hr_value(sensor_filter_update(HOMEWIND_METRIC_HR, value), self), self);
 }
 
 /* ============================================================================
- * CSC Widget API Implementation (with Change-Guards - O1 optimization)
+ * CSC Widget API Implementation (mailbox, thread-safe)
  * ============================================================================ */
 
 void homewind_set_csc(csc_state_t state, const char* sensor_name, uint16_t cadence)
 {
-    bool changed = false;
-    if (state != csc_current_state) { csc_current_state = state; changed = true; }
-    if (sensor_name && strcmp(sensor_name, csc_sensor_name) != 0) {
-        strncpy(csc_sensor_name, sensor_name, sizeof(csc_sensor_name) - 1);
-        csc_sensor_name[sizeof(csc_sensor_name) - 1] = '\0';
-        changed = true;
-    }
-    if (cadence != csc_cadence_value) { csc_cadence_value = cadence; changed = true; }
-    if (changed) update_csc_widget();
+    const void *self = xTaskGetCurrentTaskHandle();
+    if (state != CSC_STATE_ACTIVE) sensor_filter_reset(HOMEWIND_METRIC_CADENCE);
+    ui_publish(ui_state_set_csc_state(state, self) |
+               ui_state_set_csc_name(sensor_name, self) |
+               ui_state_set_csc_cadence(sensor_filter_update(HOMEWIND_METRIC_CADENCE, cadence), self), self);
 }
 
 void homewind_set_csc_state(csc_state_t state)
 {
-    if (state != csc_current_state) {
-        csc_current_state = state;
-        update_csc_widget();
-    }
+    const void *self = xTaskGetCurrentTaskHandle();
+    if (state != CSC_STATE_ACTIVE) sensor_filter_reset(HOMEWIND_METRIC_CADENCE);
+    ui_publish(ui_state_set_csc_state(state, self), self);
 }
 
 void homewind_set_csc_cadence(uint16_t cadence)
 {
-    if (cadence != csc_cadence_value) {
-        csc_cadence_value = cadence;
-        update_csc_widget();
-    }
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_csc_cadence(sensor_filter_update(HOMEWIND_METRIC_CADENCE, cadence), self), self);
 }
 
 /* ============================================================================
- * Fan Widget API Implementation (with Change-Guards - O1 optimization)
+ * Fan Widget API Implementation (mailbox, thread-safe)
  * ============================================================================ */
 
 void homewind_set_fan(uint8_t fan_index, fan_state_t state, bool is_on)
 {
-    if (fan_index >= MAX_FANS) return;
-    if (fan_items[fan_index].state == state && fan_items[fan_index].is_on == is_on) return;
-    fan_items[fan_index].state = state;
-    fan_items[fan_index].is_on = is_on;
-    update_fan_item(fan_index);
-    update_powersave_display();
+    if (fan_index >= HOMEWIND_MAX_FANS) return;
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_fan(fan_index, state, is_on, self), self);
 }
 
 void homewind_set_fan_state(uint8_t fan_index, fan_state_t state)
 {
-    if (fan_index >= MAX_FANS) return;
-    if (fan_items[fan_index].state == state) return;
-    fan_items[fan_index].state = state;
-    if (state == FAN_STATE_NOT_CONFIGURATED || state == FAN_STATE_INACTIVE) {
-        fan_items[fan_index].is_on = false;
-    }
-    update_fan_item(fan_index);
-    update_powersave_display();
+    if (fan_index >= HOMEWIND_MAX_FANS) return;
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_fan_state(fan_index, state, self), self);
 }
 
 void homewind_set_fan_toggle(uint8_t fan_index, bool is_on)
 {
-    if (fan_index >= MAX_FANS) return;
-    if (fan_items[fan_index].is_on == is_on) return;
-    fan_items[fan_index].is_on = is_on;
-    update_fan_item(fan_index);
-    animate_fan_toggle(fan_index);
-    update_powersave_display();
+    if (fan_index >= HOMEWIND_MAX_FANS) return;
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_fan_on(fan_index, is_on, true, self), self);
+}
+
+void homewind_set_fans(const fan_state_t* states, const bool* is_on, uint8_t count)
+{
+    if (!states) return;
+    if (count > HOMEWIND_MAX_FANS) count = HOMEWIND_MAX_FANS;
+    const void *self = xTaskGetCurrentTaskHandle();
+    uint32_t fields = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        fields |= ui_state_set_fan(i, states[i], is_on ? is_on[i] : false, self);
+    }
+    ui_publish(fields, self);
+}
+
+void homewind_set_fan_count(uint8_t count)
+{
+    if (count > HOMEWIND_MAX_FANS) count = HOMEWIND_MAX_FANS;
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_fan_count(count, self), self);
+}
+
+/* ============================================================================
+ * Refresh Scheduling
+ * ============================================================================ */
+
+void homewind_set_refresh_limit(homewind_widget_t widget, uint8_t max_hz)
+{
+    if (widget >= HOMEWIND_WIDGET_COUNT) return;
+    widget_refresh[widget].interval_ms = max_hz ? (uint16_t)(1000 / max_hz) : 0;
+}
+
+void homewind_set_refresh_priority(homewind_widget_t widget, homewind_refresh_priority_t priority)
+{
+    if (widget >= HOMEWIND_WIDGET_COUNT) return;
+    widget_refresh[widget].priority = (uint8_t)priority;
+}
+
+/* ============================================================================
+ * Batch Updates
+ * ============================================================================ */
+
+void homewind_begin_update(void)
+{
+    ui_state_begin(xTaskGetCurrentTaskHandle());
+}
+
+void homewind_commit_update(void)
+{
+    if (ui_state_commit(xTaskGetCurrentTaskHandle())) {
+        lcd_lvgl_wake();
+    }
 }
 
 void homewind_set_fan_toggle_callback(fan_toggle_callback_t callback)
@@ -1240,10 +1817,8 @@ void homewind_set_fan_toggle_callback(fan_toggle_callback_t callback)
 
 void homewind_set_qr_code_url(const char* url)
 {
-    if (!url || !qr_code_widget) return;
-    strncpy(qr_code_url, url, sizeof(qr_code_url) - 1);
-    qr_code_url[sizeof(qr_code_url) - 1] = '\0';
-    lv_qrcode_update(qr_code_widget, qr_code_url, strlen(qr_code_url));
+    const void *self = xTaskGetCurrentTaskHandle();
+    ui_publish(ui_state_set_qr_url(url, self), self);
 }
 
 void homewind_hide_settings_overlay(void)
@@ -1253,36 +1828,99 @@ void homewind_hide_settings_overlay(void)
     }
 }
 
+void homewind_show_settings_overlay(void)
+{
+    if (!settings_overlay || settings_modal_visible) return;
+    on_user_activity();
+    animate_overlay_in();
+}
+
+void homewind_close_settings_overlay(void)
+{
+    if (!settings_overlay || !settings_modal_visible) return;
+    animate_overlay_out();
+}
+
 /* --- Library Initialization (idempotent) --- */
 static bool homewind_initialized = false;
 
-void homewind_init(void)
+static void homewind_init_sequential(void)
 {
-    /* Guard: Only initialize once */
-    if (homewind_initialized) {
-        return;
-    }
-    
     /* 1. Initialize touch controller */
-    extern void Touch_Init(void);
+    init_profile_begin(HOMEWIND_INIT_PHASE_TOUCH);
     Touch_Init();
+    init_profile_end(HOMEWIND_INIT_PHASE_TOUCH);
     
     /* 2. Initialize display, SPI, LVGL core, and start LVGL task */
-    extern void lcd_lvgl_Init(void);
     lcd_lvgl_Init();
     
     /* 3. Create UI screens (main screen with widgets, settings modal) */
+    init_profile_begin(HOMEWIND_INIT_PHASE_SCREENS);
     homewind_create_screens();
+    init_profile_end(HOMEWIND_INIT_PHASE_SCREENS);
     
     /* 4. Initialize power save system (timers, overlays, breathing animation) */
-    extern void powersave_init(void);
+    init_profile_begin(HOMEWIND_INIT_PHASE_POWERSAVE);
     powersave_init();
+    init_profile_end(HOMEWIND_INIT_PHASE_POWERSAVE);
     
-    /* 5. Start IMU rotation task if QMI8658 hardware is available */
+    /* 5. Start the IMU task (probe, calibration and self-test run inside it) */
+    #ifdef QMI8658_SLAVE_ADDR_L
+    lcd_start_imu_rotation_task();
+    #endif
+}
+
+static void homewind_init_parallel(void)
+{
+    /* 1. Touch first: creates the I2C driver shared with the IMU */
+    init_profile_begin(HOMEWIND_INIT_PHASE_TOUCH);
+    Touch_Init();
+    init_profile_end(HOMEWIND_INIT_PHASE_TOUCH);
+
+    /* 2. Panel reset + init commands run on esp_timer, no blocking delays */
+    lcd_panel_Init_async();
+
+    /* 3. IMU task: probe and calibration overlap everything below */
     #ifdef QMI8658_SLAVE_ADDR_L
-    extern bool lcd_start_imu_rotation_task(void);
     lcd_start_imu_rotation_task();
     #endif
+
+    /* 4. LVGL core + screens while the panel powers up (no panel access) */
+    lcd_lvgl_core_Init();
+    init_profile_begin(HOMEWIND_INIT_PHASE_SCREENS);
+    homewind_create_screens();
+    init_profile_end(HOMEWIND_INIT_PHASE_SCREENS);
+
+    /* 5. Powersave: backlight writes are deferred until the panel is ready */
+    init_profile_begin(HOMEWIND_INIT_PHASE_POWERSAVE);
+    powersave_init();
+    init_profile_end(HOMEWIND_INIT_PHASE_POWERSAVE);
+
+    /* 6. Start LVGL task: rendering is held until the panel is ready, then the
+     *    first frame is flushed right away. homewind_init_ex() returns now. */
+    lcd_lvgl_start_task();
+}
+
+void homewind_init_ex(homewind_init_mode_t mode)
+{
+    /* Guard: Only initialize once */
+    if (homewind_initialized) {
+        return;
+    }
+
+    init_profile_reset(mode);
+    if (mode == HOMEWIND_INIT_PARALLEL) {
+        homewind_init_parallel();
+    } else {
+        homewind_init_sequential();
+    }
+    init_profile_mark_return();
+    heap_guard_seal();
     
     homewind_initialized = true;
 }
+
+void homewind_init(void)
+{
+    homewind_init_ex(HOMEWIND_INIT_SEQUENTIAL);
+}
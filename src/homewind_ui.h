@@ -27,6 +27,10 @@ typedef enum {
     HR_STATE_ACTIVE            /* Connected, providing data */
 } hr_state_t;
 
+/* --- Fan List Size --- */
+#define HOMEWIND_MAX_FANS           8   /* Upper bound for homewind_set_fan_count() */
+#define HOMEWIND_DEFAULT_FAN_COUNT  4   /* Fans shown until homewind_set_fan_count() is called */
+
 /* --- Fan Toggle Callback --- */
 typedef void (*fan_toggle_callback_t)(uint8_t fan_index, bool is_on);
 
@@ -90,7 +94,7 @@ void homewind_set_csc_cadence(uint16_t cadence);
 
 /**
  * @brief Set fan widget with all parameters
- * @param fan_index Fan index (0-3)
+ * @param fan_index Fan index (0 to HOMEWIND_MAX_FANS-1)
  * @param state FAN_STATE_NOT_CONFIGURATED, FAN_STATE_INACTIVE, FAN_STATE_ERROR, or FAN_STATE_ACTIVE
  * @param is_on Toggle state (true = on, false = off)
  */
@@ -98,18 +102,33 @@ void homewind_set_fan(uint8_t fan_index, fan_state_t state, bool is_on);
 
 /**
  * @brief Set fan widget state only (keep is_on state, default false for new)
- * @param fan_index Fan index (0-3)
+ * @param fan_index Fan index (0 to HOMEWIND_MAX_FANS-1)
  * @param state Fan state
  */
 void homewind_set_fan_state(uint8_t fan_index, fan_state_t state);
 
 /**
  * @brief Toggle fan on/off (keep current state)
- * @param fan_index Fan index (0-3)
+ * @param fan_index Fan index (0 to HOMEWIND_MAX_FANS-1)
  * @param is_on Toggle state
  */
 void homewind_set_fan_toggle(uint8_t fan_index, bool is_on);
 
+/**
+ * @brief Set several fans at once (fans 0..count-1), published as one update
+ * @param states Array of fan states
+ * @param is_on Array of toggle states (NULL = all off)
+ * @param count Number of entries (clamped to HOMEWIND_MAX_FANS)
+ */
+void homewind_set_fans(const fan_state_t* states, const bool* is_on, uint8_t count);
+
+/**
+ * @brief Set how many fans the list shows (default 4, max HOMEWIND_MAX_FANS)
+ * More than four fans scroll vertically; only the pills in view exist as
+ * LVGL objects, so memory use does not depend on the count.
+ */
+void homewind_set_fan_count(uint8_t count);
+
 /* Legacy API (kept for backwards compatibility) */
 #define homewind_set_fan_state_impl(idx, state, on) homewind_set_fan(idx, state, on)
 
@@ -118,12 +137,63 @@ void homewind_set_fan_toggle(uint8_t fan_index, bool is_on);
  */
 void homewind_set_fan_toggle_callback(fan_toggle_callback_t callback);
 
+/* ============================================================================
+ * Refresh Scheduling
+ * ============================================================================ */
+
+typedef enum {
+    HOMEWIND_WIDGET_HR = 0,
+    HOMEWIND_WIDGET_CSC,
+    HOMEWIND_WIDGET_FANS,
+    HOMEWIND_WIDGET_COUNT
+} homewind_widget_t;
+
+typedef enum {
+    HOMEWIND_REFRESH_NORMAL = 0,  /* Waits while the panel is touched */
+    HOMEWIND_REFRESH_HIGH         /* Never deferred for touch */
+} homewind_refresh_priority_t;
+
+/**
+ * @brief Cap how often a widget's value is redrawn (defaults: HR 2 Hz, CSC 4 Hz, fans no cap)
+ * Values arriving faster are merged: the latest one is shown when the
+ * interval ends. State and name changes always render at once.
+ * @param max_hz Maximum value renders per second, 0 = no cap
+ */
+void homewind_set_refresh_limit(homewind_widget_t widget, uint8_t max_hz);
+
+/**
+ * @brief Set a widget's refresh priority (defaults: fans HIGH, HR/CSC NORMAL)
+ * NORMAL widgets hold value updates while a finger is on the panel (up to
+ * 1 s) so touch feedback renders first.
+ */
+void homewind_set_refresh_priority(homewind_widget_t widget, homewind_refresh_priority_t priority);
+
+/* ============================================================================
+ * Batch Updates
+ * ============================================================================ */
+
+/**
+ * @brief Start a batch of setter calls
+ * Setters called from this task stage their values in the batch; none of
+ * them is shown until the matching homewind_commit_update() from the same task.
+ * Setters from other tasks (e.g. BLE callbacks) are not held. Batches nest;
+ * keep them short.
+ */
+void homewind_begin_update(void);
+
+/**
+ * @brief Close a batch; the outermost commit applies all staged changes
+ * in the next frame (one widget pass, one powersave recount)
+ */
+void homewind_commit_update(void);
+
 /* ============================================================================
  * Settings & Utility
  * ============================================================================ */
 
 /**
  * @brief Set QR code URL in settings modal
+ * Only stores the URL; the QR matrix is encoded when the modal opens.
  */
 void homewind_set_qr_code_url(const char* url);
 
@@ -132,6 +202,13 @@ void homewind_set_qr_code_url(const char* url);
  */
 void homewind_hide_settings_overlay(void);
 
+/**
+ * @brief Slide the settings overlay in / out, as the settings and close buttons do
+ * LVGL context: call with lcd_lvgl_lock() held (e.g. scripted UI tests, benchmarks).
+ */
+void homewind_show_settings_overlay(void);
+void homewind_close_settings_overlay(void);
+
 /**
  * @brief Refresh powersave screen labels (HR/CSC/fan) – call when entering SOFT_POWERSAVE
  */
@@ -0,0 +1,171 @@
+// imu_fusion.c
+#include "imu_fusion.h"
+#include <stdlib.h>
+
+/* --- Filter tuning --- */
+#define FUSION_FRAC_BITS        8   /* Gravity vector in Q8 accelerometer counts */
+#define FUSION_ACC_SHIFT        1   /* Accel only: EMA 1/2 per batch (the batch is already a mean) */
+#define FUSION_ACC_SHIFT_GYRO   3   /* With gyro: pull 1/8 per batch toward the accelerometer */
+#define FUSION_UNTRUSTED_SHIFT  2   /* Extra shift while |acc| is outside 0.75..1.25 g */
+#define FUSION_FACE_DOWN_ENTER  13  /* 16ths of 1 g toward the ground (~0.8 g) */
+#define FUSION_FACE_DOWN_LEAVE  10  /* 16ths of 1 g (~0.6 g) */
+#define FUSION_MAX_DT_MS        500 /* Longer gaps (missed batch) are clamped */
+#define FUSION_MAX_THETA_Q30    (1 << 29)  /* 0.5 rad per batch and axis: saturates fast turns
+                                            * (512 dps * 500 ms is 4.5 rad, past int32 in Q30) */
+
+typedef struct {
+    int32_t g_q8[3];
+    int64_t acc_norm_lo;    /* |acc|^2 band where the accelerometer is trusted */
+    int64_t acc_norm_hi;
+    int32_t gyro_rad_q30;   /* Gyro count * ms -> radians in Q30 */
+    uint16_t acc_lsb;
+    uint32_t face_down_ms;
+    bool face_down;
+    bool primed;
+} imu_fusion_t;
+
+static imu_fusion_t fusion;
+
+/* ============================================================================
+ * Integer Math
+ * ============================================================================ */
+
+static uint32_t isqrt32(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+/* atan(r) in 0.1 degree for r = 0..1 in Q15: pi/4*r + 0.273*r*(1-r) */
+static int32_t atan_unit_deg10(int64_t r_q15)
+{
+    return (int32_t)((r_q15 * (450LL * 32768 + 156LL * (32768 - r_q15))) >> 30);
+}
+
+static int16_t atan2_deg10(int32_t y, int32_t x)
+{
+    int64_t ay = llabs(y);
+    int64_t ax = llabs(x);
+    if (ax == 0 && ay == 0) return 0;
+
+    int32_t a = (ax >= ay) ? atan_unit_deg10((ay << 15) / ax)
+                           : 900 - atan_unit_deg10((ax << 15) / ay);
+    if (x < 0) a = 1800 - a;
+    return (int16_t)((y < 0) ? -a : a);
+}
+
+static int16_t q8_to_counts(int32_t v)
+{
+    return (int16_t)((v + (1 << (FUSION_FRAC_BITS - 1))) >> FUSION_FRAC_BITS);
+}
+
+/* ============================================================================
+ * Filter
+ * ============================================================================ */
+
+void imu_fusion_init(uint16_t acc_lsb_per_g, uint16_t gyro_lsb_per_dps)
+{
+    int64_t lsb2 = (int64_t)acc_lsb_per_g * acc_lsb_per_g;
+
+    fusion.primed = false;
+    fusion.face_down = false;
+    fusion.face_down_ms = 0;
+    fusion.acc_lsb = acc_lsb_per_g;
+    fusion.acc_norm_lo = lsb2 * 9 / 16;
+    fusion.acc_norm_hi = lsb2 * 25 / 16;
+    /* pi / 180 / 1000 / lsb * 2^30, pi as 314159 / 100000 */
+    fusion.gyro_rad_q30 = gyro_lsb_per_dps
+        ? (int32_t)((1073741824ULL * 314159ULL + 9000000000ULL * gyro_lsb_per_dps)
+                    / (18000000000ULL * gyro_lsb_per_dps))
+        : 0;
+}
+
+bool imu_fusion_update(const int16_t acc[3], const int16_t gyro[3], uint32_t dt_ms)
+{
+    int32_t *g = fusion.g_q8;
+    if (dt_ms > FUSION_MAX_DT_MS) dt_ms = FUSION_MAX_DT_MS;
+
+    if (!fusion.primed) {
+        for (int i = 0; i < 3; i++) g[i] = (int32_t)acc[i] << FUSION_FRAC_BITS;
+        fusion.primed = true;
+    } else {
+        bool use_gyro = gyro && fusion.gyro_rad_q30;
+        if (use_gyro) {
+            /* Rotate gravity in the body frame, second order: g += g x theta - g * |theta|^2 / 2 */
+            int32_t th[3];
+            int64_t th2 = 0;
+            for (int i = 0; i < 3; i++) {
+                int64_t t = (int64_t)gyro[i] * (int32_t)dt_ms * fusion.gyro_rad_q30;
+                if (t > FUSION_MAX_THETA_Q30) t = FUSION_MAX_THETA_Q30;
+                if (t < -FUSION_MAX_THETA_Q30) t = -FUSION_MAX_THETA_Q30;
+                th[i] = (int32_t)t;
+                th2 += ((int64_t)th[i] * th[i]) >> 30;
+            }
+            int32_t gx = g[0], gy = g[1], gz = g[2];
+            g[0] += (int32_t)(((int64_t)gy * th[2] - (int64_t)gz * th[1] - gx * th2 / 2) >> 30);
+            g[1] += (int32_t)(((int64_t)gz * th[0] - (int64_t)gx * th[2] - gy * th2 / 2) >> 30);
+            g[2] += (int32_t)(((int64_t)gx * th[1] - (int64_t)gy * th[0] - gz * th2 / 2) >> 30);
+        }
+
+        int64_t n2 = (int64_t)acc[0] * acc[0] + (int64_t)acc[1] * acc[1] + (int64_t)acc[2] * acc[2];
+        uint8_t shift = use_gyro ? FUSION_ACC_SHIFT_GYRO : FUSION_ACC_SHIFT;
+        if (n2 < fusion.acc_norm_lo || n2 > fusion.acc_norm_hi) shift += FUSION_UNTRUSTED_SHIFT;
+        for (int i = 0; i < 3; i++) {
+            g[i] += (((int32_t)acc[i] << FUSION_FRAC_BITS) - g[i]) >> shift;
+        }
+    }
+
+    /* Face down: gravity mostly along Z toward the ground, with hysteresis and hold time */
+    int32_t down = IMU_FUSION_FACE_DOWN_Z_SIGN * (int32_t)q8_to_counts(g[2]);
+    int32_t lsb = fusion.acc_lsb;
+    if (!fusion.face_down) {
+        if (down > lsb * FUSION_FACE_DOWN_ENTER / 16) {
+            fusion.face_down_ms += dt_ms;
+            if (fusion.face_down_ms >= IMU_FUSION_FACE_DOWN_HOLD_MS) {
+                fusion.face_down = true;
+                return true;
+            }
+        } else {
+            fusion.face_down_ms = 0;
+        }
+    } else if (down < lsb * FUSION_FACE_DOWN_LEAVE / 16) {
+        fusion.face_down = false;
+        fusion.face_down_ms = 0;
+    }
+    return false;
+}
+
+bool imu_fusion_get_gravity(int16_t g[3])
+{
+    if (!fusion.primed) return false;
+    for (int i = 0; i < 3; i++) g[i] = q8_to_counts(fusion.g_q8[i]);
+    return true;
+}
+
+bool imu_fusion_get_tilt(int16_t *pitch_deg10, int16_t *roll_deg10)
+{
+    int16_t g[3];
+    if (!imu_fusion_get_gravity(g)) return false;
+    if (pitch_deg10) {
+        uint32_t yz = (uint32_t)((int32_t)g[1] * g[1]) + (uint32_t)((int32_t)g[2] * g[2]);
+        *pitch_deg10 = atan2_deg10(-(int32_t)g[0], (int32_t)isqrt32(yz));
+    }
+    if (roll_deg10) *roll_deg10 = atan2_deg10(g[1], g[2]);
+    return true;
+}
+
+bool imu_fusion_is_face_down(void)
+{
+    return fusion.face_down;
+}
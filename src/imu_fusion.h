@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * IMU Tilt Fusion (gravity vector)
+ * ============================================================================
+ * Fixed-point complementary filter fed once per FIFO batch by the IMU task.
+ * With gyro data the gravity vector is rotated by the integrated angular rate
+ * and pulled toward the accelerometer by 1/2^n per batch; accelerometer
+ * readings far from 1 g (bumps, handlebar vibration) are not trusted. Without
+ * gyro it degrades to an EMA of the accelerometer. All integer, no libm.
+ * State belongs to the IMU task; the getters may tear between axes when read
+ * from another task, which only matters for a single batch.
+ * ============================================================================ */
+
+/* Gravity sign on Z when the screen faces the ground (board dependent) */
+#ifndef IMU_FUSION_FACE_DOWN_Z_SIGN
+#define IMU_FUSION_FACE_DOWN_Z_SIGN   (-1)
+#endif
+#define IMU_FUSION_FACE_DOWN_HOLD_MS  600   /* Face down this long before the event fires */
+
+/**
+ * @brief Reset the filter; the next update restarts from the raw accelerometer
+ * @param acc_lsb_per_g Accelerometer counts per g
+ * @param gyro_lsb_per_dps Gyro counts per deg/s (0 = accelerometer only)
+ */
+void imu_fusion_init(uint16_t acc_lsb_per_g, uint16_t gyro_lsb_per_dps);
+
+/**
+ * @brief Feed one batch mean
+ * @param acc Accelerometer, raw counts (board axes)
+ * @param gyro Gyro, raw counts, or NULL
+ * @param dt_ms Time covered by the batch
+ * @return true once when the device has been face down for IMU_FUSION_FACE_DOWN_HOLD_MS
+ */
+bool imu_fusion_update(const int16_t acc[3], const int16_t gyro[3], uint32_t dt_ms);
+
+/** @brief Fused gravity vector in accelerometer counts; false before the first update */
+bool imu_fusion_get_gravity(int16_t g[3]);
+
+/**
+ * @brief Tilt angles of the fused gravity vector, in 0.1 degree
+ * pitch: rotation about Y (-900..900), roll: about X (-1800..1800).
+ * Computed on demand (integer atan2, about 0.3 degree error).
+ */
+bool imu_fusion_get_tilt(int16_t *pitch_deg10, int16_t *roll_deg10);
+
+/** @brief true while the screen faces the ground */
+bool imu_fusion_is_face_down(void);
+
+#ifdef __cplusplus
+}
+#endif
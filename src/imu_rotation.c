@@ -0,0 +1,102 @@
+// imu_rotation.c
+#include "imu_rotation.h"
+#include "imu_fusion.h"
+#include "qmi8658c.h"
+#include <stdlib.h>
+
+#define ROT_0     0
+#define ROT_90    1
+#define ROT_180   2
+#define ROT_270   3
+
+/* Target orientation for the fused gravity vector, with hysteresis around the current one.
+ * Use higher threshold to enter new state, lower to exit (prevents oscillation) */
+static uint8_t target_rotation(const imu_rotation_t *r, const int16_t g[3])
+{
+    uint8_t current = r->current;
+    bool landscape = (current == ROT_90 || current == ROT_270);
+
+    if (r->four_way) {
+        int32_t ax = abs(g[0]);
+        int32_t ay = abs(g[1]);
+        if (!landscape && ay > ax + r->axis_margin) {
+            return (g[1] > 0) ? ROT_90 : ROT_270;
+        }
+        if (landscape && ax > ay + r->axis_margin) {
+            return (g[0] > 0) ? ROT_0 : ROT_180;
+        }
+    } else if (landscape) {
+        /* Four-way turned off while in landscape: back to the nearer portrait orientation */
+        return (g[0] >= 0) ? ROT_0 : ROT_180;
+    }
+
+    if (landscape) {
+        /* 90° <-> 270° on the Y axis, same thresholds as 0° <-> 180° on X */
+        if (current == ROT_90 && g[1] < r->enter_flipped) return ROT_270;
+        if (current == ROT_270 && g[1] > r->enter_normal) return ROT_90;
+        return current;
+    }
+
+    if (current == ROT_0) {
+        /* Currently normal: need stronger signal to rotate to 180° */
+        if (g[0] < r->enter_flipped) return ROT_180;
+    } else {
+        /* Currently 180°: need stronger signal to rotate to normal */
+        if (g[0] > r->enter_normal) return ROT_0;
+    }
+    return current;
+}
+
+void imu_rotation_init(imu_rotation_t *r, uint8_t rotation, uint16_t acc_lsb_per_g, uint16_t gyro_lsb_per_dps)
+{
+    r->current = rotation;
+    r->pending = rotation;
+    r->stable_count = 0;
+    imu_fusion_init(acc_lsb_per_g, gyro_lsb_per_dps);
+}
+
+void imu_rotation_set_thresholds(imu_rotation_t *r, float tilt_right, float tilt_left, uint16_t acc_lsb_per_g)
+{
+    /* Same conversion as the driver's qmi8658_acc_to_raw(), for the range the task reads */
+    r->enter_normal = qmi8658_acc_to_raw_lsb(tilt_right + IMU_ROTATION_HYSTERESIS, acc_lsb_per_g);
+    r->enter_flipped = qmi8658_acc_to_raw_lsb(tilt_left - IMU_ROTATION_HYSTERESIS, acc_lsb_per_g);
+    r->axis_margin = qmi8658_acc_to_raw_lsb(IMU_ROTATION_AXIS_MARGIN, acc_lsb_per_g);
+}
+
+uint8_t imu_rotation_process(imu_rotation_t *r, const int16_t acc[3], const int16_t gyro[3],
+                             uint32_t dt_ms, bool decide)
+{
+    uint8_t evt = 0;
+    bool was_face_down = imu_fusion_is_face_down();
+
+    if (imu_fusion_update(acc, gyro, dt_ms)) evt |= IMU_ROTATION_EVT_FACE_DOWN;
+    if (was_face_down && !imu_fusion_is_face_down()) evt |= IMU_ROTATION_EVT_LIFTED;
+
+    if (imu_fusion_is_face_down() || !decide) {
+        r->stable_count = 0;
+        return evt;
+    }
+
+    int16_t g[3];
+    imu_fusion_get_gravity(g);
+    uint8_t target = target_rotation(r, g);
+
+    /* Require stable readings before actually rotating (debounce). When this batch mean
+     * alone already points the same way as the filtered vector, the EMA has caught up
+     * with a held orientation: one full batch is enough. */
+    uint8_t needed = (target_rotation(r, acc) == target) ? 1 : IMU_ROTATION_STABLE_COUNT;
+    if (target == r->current) {
+        r->stable_count = 0;
+        return evt;
+    }
+    if (target != r->pending) {
+        r->pending = target;
+        r->stable_count = 0;
+    }
+    if (++r->stable_count >= needed) {
+        r->current = target;
+        r->stable_count = 0;
+        evt |= IMU_ROTATION_EVT_ROTATE;
+    }
+    return evt;
+}
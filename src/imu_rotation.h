@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * IMU Rotation Decision
+ * ============================================================================
+ * Per-batch pipeline of the IMU rotation task: tilt fusion (imu_fusion.c),
+ * face-down edges and the debounced orientation decision. No LVGL, FreeRTOS
+ * or driver calls, so the host replay runner (extras/imu_replay) runs exactly
+ * the code the device runs. Rotations use the lv_disp_rot_t values 0..3.
+ * ============================================================================ */
+
+#define IMU_ROTATION_HYSTERESIS     0.3f  /* m/s², band around the tilt thresholds */
+#define IMU_ROTATION_STABLE_COUNT   2     /* Batches with the same target before rotating (1 if the batch mean agrees) */
+#define IMU_ROTATION_AXIS_MARGIN    2.0f  /* m/s², four-way: lead of the other axis for portrait <-> landscape */
+
+/* imu_rotation_process() events */
+#define IMU_ROTATION_EVT_ROTATE     0x01  /* current changed */
+#define IMU_ROTATION_EVT_FACE_DOWN  0x02
+#define IMU_ROTATION_EVT_LIFTED     0x04  /* Face down -> face up */
+
+typedef struct {
+    /* Thresholds in raw accelerometer counts */
+    int16_t enter_normal;   /* tilt_right + hysteresis */
+    int16_t enter_flipped;  /* tilt_left - hysteresis */
+    int16_t axis_margin;
+    bool four_way;
+    uint8_t current;
+    uint8_t pending;
+    uint8_t stable_count;
+} imu_rotation_t;
+
+/** @brief Batch length in ms from the sample count and the ODR in 0.1 Hz */
+static inline uint32_t imu_rotation_batch_ms(uint16_t samples, uint16_t odr_dhz)
+{
+    return odr_dhz ? (uint32_t)samples * 10000u / odr_dhz : 0;
+}
+
+/** @brief Start at `rotation`; also resets the tilt fusion */
+void imu_rotation_init(imu_rotation_t *r, uint8_t rotation, uint16_t acc_lsb_per_g, uint16_t gyro_lsb_per_dps);
+
+/** @brief Convert the tilt thresholds (m/s²) to counts; call once per change */
+void imu_rotation_set_thresholds(imu_rotation_t *r, float tilt_right, float tilt_left, uint16_t acc_lsb_per_g);
+
+/**
+ * @brief Feed one FIFO batch mean
+ * @param gyro Raw gyro counts or NULL
+ * @param decide false while the display is not up: fusion runs, no rotation is picked
+ * @return IMU_ROTATION_EVT_* bits; on EVT_ROTATE the new orientation is r->current
+ */
+uint8_t imu_rotation_process(imu_rotation_t *r, const int16_t acc[3], const int16_t gyro[3],
+                             uint32_t dt_ms, bool decide);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,105 @@
+// imu_trace.c
+#include "imu_trace.h"
+#include "qmi8658c.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#define MARK_NONE   (-1)
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    _Atomic size_t pos;
+    _Atomic int mark;       /* Pending imu_trace_mark(), MARK_NONE if none */
+    int64_t last_us;
+} imu_trace_t;
+
+static imu_trace_t trace = { .mark = MARK_NONE };
+
+/* --- Append (IMU task) --- */
+static bool trace_append(const imu_trace_record_t *rec)
+{
+    size_t pos = atomic_load_explicit(&trace.pos, memory_order_relaxed);
+    if (pos + sizeof(*rec) > trace.size) return false;  /* Full: keep what we have */
+    memcpy(trace.buf + pos, rec, sizeof(*rec));
+    atomic_store_explicit(&trace.pos, pos + sizeof(*rec), memory_order_release);
+    return true;
+}
+
+static uint16_t trace_dt_ms(void)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t dt = (now - trace.last_us) / 1000;
+    trace.last_us += dt * 1000;  /* Keep the remainder so rounding does not drift */
+    return (uint16_t)(dt > 65535 ? 65535 : dt);
+}
+
+/* --- Driver hook (IMU task context) --- */
+static void trace_hook(const short acc[3], const short gyro[3], unsigned short samples)
+{
+    imu_trace_record_t rec;
+
+    int mark = atomic_exchange_explicit(&trace.mark, MARK_NONE, memory_order_relaxed);
+    if (mark != MARK_NONE) {
+        memset(&rec, 0, sizeof(rec));
+        rec.dt_ms = trace_dt_ms();
+        rec.flags = IMU_TRACE_REC_MARK;
+        rec.acc[0] = (int16_t)mark;
+        if (!trace_append(&rec)) return;
+    }
+
+    rec.dt_ms = trace_dt_ms();
+    rec.samples = (uint8_t)(samples > 255 ? 255 : samples);
+    rec.flags = gyro ? IMU_TRACE_REC_GYRO : 0;
+    for (int i = 0; i < 3; i++) {
+        rec.acc[i] = acc[i];
+        rec.gyro[i] = gyro ? gyro[i] : 0;
+    }
+    trace_append(&rec);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool imu_trace_start(uint8_t *buf, size_t size)
+{
+    imu_trace_header_t hdr;
+
+    if (!buf || size < sizeof(hdr) + sizeof(imu_trace_record_t)) return false;
+    if (qmi8658_get_acc_lsb() == 0) return false;  /* IMU not initialized */
+
+    qmi8658_set_trace_hook(NULL);
+    memcpy(hdr.magic, IMU_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = IMU_TRACE_VERSION;
+    hdr.flags = (qmi8658_get_sensors() & QMI8658_GYR_ENABLE) ? IMU_TRACE_HDR_GYRO : 0;
+    hdr.acc_lsb = qmi8658_get_acc_lsb();
+    hdr.gyro_lsb = qmi8658_get_gyro_lsb();
+    hdr.odr_dhz = qmi8658_get_odr_dhz();
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    trace.buf = buf;
+    trace.size = size;
+    trace.last_us = esp_timer_get_time();
+    atomic_store_explicit(&trace.mark, MARK_NONE, memory_order_relaxed);
+    atomic_store_explicit(&trace.pos, sizeof(hdr), memory_order_release);
+    qmi8658_set_trace_hook(trace_hook);
+    return true;
+}
+
+size_t imu_trace_stop(void)
+{
+    qmi8658_set_trace_hook(NULL);
+    return imu_trace_size();
+}
+
+size_t imu_trace_size(void)
+{
+    return atomic_load_explicit(&trace.pos, memory_order_acquire);
+}
+
+void imu_trace_mark(uint8_t rotation)
+{
+    atomic_store_explicit(&trace.mark, (int)(rotation & 3u), memory_order_relaxed);
+}
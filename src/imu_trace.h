@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * IMU Trace Recording
+ * ============================================================================
+ * Compact binary log of the QMI8658 readings the rotation task consumes, for
+ * tuning the rotation logic offline (extras/imu_replay). A driver hook
+ * (qmi8658_set_trace_hook) appends one record per read: FIFO batch means,
+ * qmi8658_read_xyz() / qmi8658_read_xyz_raw() samples. Records go into a
+ * caller-supplied buffer (PSRAM is fine); save it to flash / SD or send it
+ * over serial after imu_trace_stop().
+ *
+ * File layout, little endian: imu_trace_header_t, then imu_trace_record_t
+ * until the end. 16 bytes per record, about 84 bytes/s at 21 Hz with the
+ * default 4-sample batches, so 1 MB holds over three hours of riding.
+ * ============================================================================ */
+
+#define IMU_TRACE_MAGIC         "QMIT"
+#define IMU_TRACE_VERSION       1
+
+#define IMU_TRACE_HDR_GYRO      0x01    /* Gyro was running (records may carry gyro) */
+
+#define IMU_TRACE_REC_GYRO      0x01    /* gyro[] is valid */
+#define IMU_TRACE_REC_MARK      0x80    /* Marker, acc[0] = expected rotation (0..3), no sample */
+
+typedef struct __attribute__((packed)) {
+    char magic[4];          /* IMU_TRACE_MAGIC */
+    uint8_t version;
+    uint8_t flags;          /* IMU_TRACE_HDR_* */
+    uint16_t acc_lsb;       /* Counts per g */
+    uint16_t gyro_lsb;      /* Counts per deg/s */
+    uint16_t odr_dhz;       /* Accelerometer ODR in 0.1 Hz */
+} imu_trace_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t dt_ms;         /* Since the previous record (saturates at 65535) */
+    uint8_t samples;        /* Samples averaged into this record */
+    uint8_t flags;          /* IMU_TRACE_REC_* */
+    int16_t acc[3];         /* Raw counts, board axes */
+    int16_t gyro[3];
+} imu_trace_record_t;
+
+/**
+ * @brief Start recording into buf (header written immediately)
+ * @return false if buf cannot hold the header and one record, or the IMU is not up
+ */
+bool imu_trace_start(uint8_t *buf, size_t size);
+
+/** @brief Stop recording; returns the bytes used in buf (header + records) */
+size_t imu_trace_stop(void);
+
+/** @brief Bytes recorded so far (any task) */
+size_t imu_trace_size(void);
+
+/**
+ * @brief Mark the expected orientation from now on (ground truth for the replay)
+ * Safe from any task; written before the next record.
+ */
+void imu_trace_mark(uint8_t rotation);
+
+#ifdef __cplusplus
+}
+#endif
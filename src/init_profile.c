@@ -0,0 +1,82 @@
+// init_profile.c
+#include "init_profile.h"
+#include "esp_timer.h"
+#include <string.h>
+
+/* --- State ---
+ * Each phase slot is written by exactly one task, so no locking is needed.
+ * Times are relative to init_profile_reset() (start of homewind_init). */
+static homewind_init_timing_t init_timing = {0};
+static int64_t init_t0_us = 0;
+static bool init_t0_valid = false;
+static bool first_frame_marked = false;
+
+static const char *const phase_names[HOMEWIND_INIT_PHASE_COUNT] = {
+    "touch",
+    "panel_bus",
+    "panel_reset",
+    "panel_init",
+    "lvgl_core",
+    "screens",
+    "panel_wait",
+    "powersave",
+    "imu",
+};
+
+static uint32_t elapsed_us(void)
+{
+    if (!init_t0_valid) {
+        /* BSP used without homewind_init(): start the clock at first phase */
+        init_t0_us = esp_timer_get_time();
+        init_t0_valid = true;
+    }
+    return (uint32_t)(esp_timer_get_time() - init_t0_us);
+}
+
+void init_profile_reset(homewind_init_mode_t mode)
+{
+    memset(&init_timing, 0, sizeof(init_timing));
+    init_timing.mode = mode;
+    init_t0_us = esp_timer_get_time();
+    init_t0_valid = true;
+    first_frame_marked = false;
+}
+
+void init_profile_begin(homewind_init_phase_t phase)
+{
+    if (phase >= HOMEWIND_INIT_PHASE_COUNT) return;
+    init_timing.phases[phase].start_us = elapsed_us();
+    init_timing.phases[phase].duration_us = 0;
+    init_timing.phases[phase].ran = false;
+}
+
+void init_profile_end(homewind_init_phase_t phase)
+{
+    if (phase >= HOMEWIND_INIT_PHASE_COUNT) return;
+    homewind_init_phase_timing_t *p = &init_timing.phases[phase];
+    p->duration_us = elapsed_us() - p->start_us;
+    p->ran = true;
+}
+
+void init_profile_mark_return(void)
+{
+    init_timing.init_return_us = elapsed_us();
+}
+
+void init_profile_mark_first_frame(void)
+{
+    if (first_frame_marked) return;
+    first_frame_marked = true;
+    init_timing.first_frame_us = elapsed_us();
+}
+
+const homewind_init_timing_t* homewind_get_init_timing(void)
+{
+    return &init_timing;
+}
+
+const char* homewind_init_phase_name(homewind_init_phase_t phase)
+{
+    if (phase >= HOMEWIND_INIT_PHASE_COUNT) return "?";
+    return phase_names[phase];
+}
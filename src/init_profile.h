@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Init Mode --- */
+typedef enum {
+    HOMEWIND_INIT_SEQUENTIAL = 0,  /* Classic order, everything on the calling task */
+    HOMEWIND_INIT_PARALLEL         /* Async panel bring-up overlaps LVGL/screen creation */
+} homewind_init_mode_t;
+
+/* --- Startup Phases --- */
+typedef enum {
+    HOMEWIND_INIT_PHASE_TOUCH = 0,     /* I2C bus + FT3168 */
+    HOMEWIND_INIT_PHASE_PANEL_BUS,     /* QSPI bus, panel IO, SH8601 handle */
+    HOMEWIND_INIT_PHASE_PANEL_RESET,   /* Hardware reset pulse + settle time */
+    HOMEWIND_INIT_PHASE_PANEL_INIT,    /* Init commands (sleep-out, display on); async: incl. reset */
+    HOMEWIND_INIT_PHASE_LVGL_CORE,     /* lv_init, draw buffers, drivers, tick timer */
+    HOMEWIND_INIT_PHASE_SCREENS,       /* Boot/AP/main screens + settings modal */
+    HOMEWIND_INIT_PHASE_PANEL_WAIT,    /* LVGL task ready, first frame held for the panel (parallel mode) */
+    HOMEWIND_INIT_PHASE_POWERSAVE,     /* powersave_init */
+    HOMEWIND_INIT_PHASE_IMU,           /* QMI8658 probe + calibration (IMU task, both modes) */
+    HOMEWIND_INIT_PHASE_COUNT
+} homewind_init_phase_t;
+
+/**
+ * @brief Timing of one startup phase (microseconds since init start)
+ * A phase that did not run has duration_us == 0 and ran == false.
+ */
+typedef struct {
+    uint32_t start_us;
+    uint32_t duration_us;
+    bool ran;
+} homewind_init_phase_timing_t;
+
+/**
+ * @brief Startup timing report filled by homewind_init()/homewind_init_ex()
+ */
+typedef struct {
+    homewind_init_mode_t mode;
+    homewind_init_phase_timing_t phases[HOMEWIND_INIT_PHASE_COUNT];
+    uint32_t init_return_us;   /* homewind_init() returned to the caller */
+    uint32_t first_frame_us;   /* First flush sent to the panel (0 = not yet) */
+} homewind_init_timing_t;
+
+/**
+ * @brief Get the startup timing report
+ * Phases running on helper tasks (the IMU task) may still be
+ * in progress when homewind_init() returns; first_frame_us is set later by
+ * the LVGL task.
+ */
+const homewind_init_timing_t* homewind_get_init_timing(void);
+
+/**
+ * @brief Human-readable phase name (e.g. for Serial output)
+ */
+const char* homewind_init_phase_name(homewind_init_phase_t phase);
+
+/* --- Internal (library) --- */
+void init_profile_reset(homewind_init_mode_t mode);
+void init_profile_begin(homewind_init_phase_t phase);
+void init_profile_end(homewind_init_phase_t phase);
+void init_profile_mark_return(void);
+void init_profile_mark_first_frame(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,16 @@
 #include "homewind_ui.h"
 #include "FT3168.h"
 #include "qmi8658c.h"  // QMI8658 IMU driver - automatically included for rotation support
+#include "imu_rotation.h"
+#include "imu_fusion.h"
+#include "init_profile.h"
+#include "heap_guard.h"
+#include "mem_stats.h"
+#include "perf_stats.h"
+#include "event_trace.h"
+#include <stdatomic.h>
+
+static const char *TAG = "lcd_bsp";
 
 static SemaphoreHandle_t lvgl_mux = NULL; //mutex semaphores
 #define LCD_HOST    SPI2_HOST
@@ -23,6 +33,8 @@ static lv_disp_drv_t *g_disp_drv = NULL;
 // These control the sensitivity of automatic rotation detection
 static float g_imu_tilt_right_threshold = 1.0f;   // Tilt right threshold (normal orientation)
 static float g_imu_tilt_left_threshold = -1.0f;   // Tilt left threshold (180° rotation)
+static volatile bool g_imu_four_way = false;       // Also detect 90°/270° (landscape) on the Y axis
+static volatile bool g_imu_thresholds_changed = true;  // IMU task re-converts them to raw counts
 #endif
 
 // Forward declaration for IMU rotation task (if QMI8658 is available)
@@ -47,11 +59,96 @@ static const sh8601_lcd_init_cmd_t lcd_init_cmds[] =
   {0x51, (uint8_t []){0xFF}, 1, 0},    //亮度
 };
 
-void lcd_lvgl_Init(void)
+static lv_disp_draw_buf_t disp_buf; // contains internal graphic buffer(s) called draw buffer(s)
+static lv_disp_drv_t disp_drv;      // contains callback functions (also flush-done context of the panel IO)
+static esp_lcd_panel_handle_t amoled_panel_handle = NULL;
+static TaskHandle_t lvgl_task_handle = NULL;
+static lcd_lvgl_frame_hook_t lvgl_frame_hook = NULL;
+static bool touch_pressed = false;  // Last touch state seen by LVGL (LVGL task only)
+static lv_indev_t *touch_indev = NULL;
+
+/* --- Frame budget (LVGL task only, except the volatile fps request) ---
+ * Each pass of the port task is timed against LVGL_FRAME_BUDGET_US plus the
+ * time the panel DMA spent on that pass's flushes (a full-screen flush alone
+ * takes longer than 16 ms). On an overrun the animation timer is slowed down,
+ * low-priority timers are pushed back by one period (at most once per run),
+ * the UI frame hook is skipped once (its changes stay in the mailbox) and the
+ * touch read is made due, so a busy frame never delays input. */
+static volatile uint8_t anim_fps_request = LVGL_ANIM_FPS_MAX;  // Power-state cap (lcd_lvgl_set_anim_fps)
+static uint8_t anim_load_shift = 0;      // Overrun halvings of the animation rate
+static uint16_t frames_in_budget = 0;
+static uint32_t anim_period_applied = 0;
+static bool defer_frame_hook = false;
+static bool frame_hook_deferred = false; // Last pass skipped the hook: never skip twice in a row
+static lv_timer_t *low_prio_timers[LVGL_LOW_PRIO_TIMERS_MAX];
+static uint32_t low_prio_deferred_at[LVGL_LOW_PRIO_TIMERS_MAX];  // last_run set by our deferral
+static uint8_t low_prio_timer_count = 0;
+static int64_t flush_start_us = 0;               // flush_cb -> DMA done (one flush in flight)
+static volatile uint32_t pass_flush_us = 0;      // DMA time of this pass's flushes (ISR adds)
+
+/* --- LVGL suspension (panel-off power tier) ---
+ * Requested from LVGL context; the port task finishes the pass, puts the
+ * panel to sleep, stops the tick timer and blocks. lcd_lvgl_wake() (new UI
+ * data) or a touch, polled directly over I2C, brings everything back. */
+static esp_timer_handle_t lvgl_tick_timer = NULL;
+static bool lvgl_suspend_req = false;               // LVGL task only
+static volatile bool lvgl_suspended = false;
+static lcd_lvgl_resume_cb_t lvgl_resume_cb = NULL;
+
+/* --- Panel readiness ---
+ * Until the SH8601 finished its init sequence nothing may be sent over QSPI:
+ * the display refresh timer is held and flushes are dropped. Backlight writes
+ * from other tasks are posted to pending_brightness (latest wins) and sent by
+ * the LVGL task between flushes, since the panel IO is not thread-safe. */
+static volatile bool panel_ready = false;
+static bool panel_refr_held = false;          // refr_timer paused until panel_ready (LVGL task only)
+static volatile bool panel_init_retry = false;  // Async init failed: LVGL task redoes it blocking
+static _Atomic int16_t pending_brightness = -1;
+static void lcd_backlight_apply_pending(void);
+static SemaphoreHandle_t panel_ready_sem = NULL;
+static bool panel_async_pending = false;
+static lcd_panel_ready_cb_t panel_ready_user_cb = NULL;
+
+/* --- Task / semaphore storage ---
+ * With LCD_STATIC_ALLOC the kernel objects live in .bss instead of the
+ * FreeRTOS heap, so nothing the library creates at boot fragments it. */
+#if LCD_STATIC_ALLOC
+static StaticSemaphore_t lvgl_mux_buf;
+static StaticSemaphore_t panel_ready_sem_buf;
+static StackType_t lvgl_task_stack[EXAMPLE_LVGL_TASK_STACK_SIZE];
+static StaticTask_t lvgl_task_tcb;
+#define LCD_STATIC(buf) (buf)
+#else
+#define LCD_STATIC(buf) NULL
+#endif
+
+static bool lcd_task_create(TaskFunction_t fn, const char *name, uint32_t stack_size, UBaseType_t prio,
+                            TaskHandle_t *handle, StackType_t *stack, StaticTask_t *tcb)
 {
-  static lv_disp_draw_buf_t disp_buf; // contains internal graphic buffer(s) called draw buffer(s)
-  static lv_disp_drv_t disp_drv;      // contains callback functions
+#if LCD_STATIC_ALLOC
+  *handle = xTaskCreateStatic(fn, name, stack_size, NULL, prio, stack, tcb);
+  return *handle != NULL;
+#else
+  (void)stack;
+  (void)tcb;
+  return xTaskCreate(fn, name, stack_size, NULL, prio, handle) == pdPASS;
+#endif
+}
+
+static SemaphoreHandle_t lcd_sem_create(bool mutex, StaticSemaphore_t *buf)
+{
+#if LCD_STATIC_ALLOC
+  return mutex ? xSemaphoreCreateMutexStatic(buf) : xSemaphoreCreateBinaryStatic(buf);
+#else
+  (void)buf;
+  return mutex ? xSemaphoreCreateMutex() : xSemaphoreCreateBinary();
+#endif
+}
 
+/* --- Panel object (QSPI bus, panel IO, SH8601 handle) --- */
+static esp_lcd_panel_handle_t lcd_panel_create(void)
+{
+  init_profile_begin(HOMEWIND_INIT_PHASE_PANEL_BUS);
   const spi_bus_config_t buscfg = SH8601_PANEL_BUS_QSPI_CONFIG(EXAMPLE_PIN_NUM_LCD_PCLK,
                                                                EXAMPLE_PIN_NUM_LCD_DATA0,
                                                                EXAMPLE_PIN_NUM_LCD_DATA1,
@@ -85,15 +182,116 @@ void lcd_lvgl_Init(void)
     .vendor_config = &vendor_config,
   };
   ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_new_panel_sh8601(io_handle, &panel_config, &panel_handle));
+  amoled_panel_handle = panel_handle;
+  init_profile_end(HOMEWIND_INIT_PHASE_PANEL_BUS);
+  return panel_handle;
+}
+
+static void lcd_panel_set_ready(esp_err_t result)
+{
+  if (result == ESP_OK) {
+    panel_ready = true;
+  }
+  if (panel_ready_sem) {
+    xSemaphoreGive(panel_ready_sem);
+  }
+  if (panel_ready_user_cb) {
+    panel_ready_user_cb(result);
+  }
+  // Wake the LVGL task: held first frame and pending backlight go out now
+  lcd_lvgl_wake();
+}
+
+/* Reset + init commands + display on, blocking (~250 ms) */
+static void lcd_panel_bring_up(esp_lcd_panel_handle_t panel_handle)
+{
   ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_reset(panel_handle));
   ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_init(panel_handle));
   ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(panel_handle, true));
+}
 
+/* --- Panel bring-up, blocking (reset + sleep-out delays ~250 ms) --- */
+void lcd_panel_Init(void)
+{
+  esp_lcd_panel_handle_t panel_handle = lcd_panel_create();
+
+  init_profile_begin(HOMEWIND_INIT_PHASE_PANEL_RESET);
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_reset(panel_handle));
+  init_profile_end(HOMEWIND_INIT_PHASE_PANEL_RESET);
+
+  init_profile_begin(HOMEWIND_INIT_PHASE_PANEL_INIT);
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_init(panel_handle));
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(panel_handle, true));
+  init_profile_end(HOMEWIND_INIT_PHASE_PANEL_INIT);
+
+  lcd_panel_set_ready(ESP_OK);
+}
+
+/* --- Panel bring-up, non-blocking (esp_timer state machine in the driver) --- */
+static void lcd_panel_init_done_cb(esp_lcd_panel_handle_t panel, esp_err_t result, void *user_ctx)
+{
+  if (result != ESP_OK) {
+    // Too slow for the esp_timer task: the LVGL task retries blocking
+    ESP_LOGE(TAG, "async panel init failed (%s), retrying blocking", esp_err_to_name(result));
+    panel_init_retry = true;
+    lcd_lvgl_wake();
+    return;
+  }
+  init_profile_end(HOMEWIND_INIT_PHASE_PANEL_INIT);
+  lcd_panel_set_ready(result);
+}
+
+bool lcd_panel_Init_async(void)
+{
+  if (!panel_ready_sem) {
+    panel_ready_sem = lcd_sem_create(false, LCD_STATIC(&panel_ready_sem_buf));
+  }
+  esp_lcd_panel_handle_t panel_handle = lcd_panel_create();
+
+  // Async path: panel_init covers reset pulse + init commands
+  init_profile_begin(HOMEWIND_INIT_PHASE_PANEL_INIT);
+  panel_async_pending = true;
+  if (esp_lcd_sh8601_init_async(panel_handle, true, lcd_panel_init_done_cb, NULL) != ESP_OK) {
+    // Timer not available: fall back to blocking bring-up
+    panel_async_pending = false;
+    lcd_panel_bring_up(panel_handle);
+    init_profile_end(HOMEWIND_INIT_PHASE_PANEL_INIT);
+    lcd_panel_set_ready(ESP_OK);
+    return false;
+  }
+  return true;
+}
+
+bool lcd_panel_wait_ready(int timeout_ms)
+{
+  if (panel_ready) return true;
+  if (!panel_async_pending || !panel_ready_sem) return false;
+  const TickType_t timeout_ticks = (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+  if (xSemaphoreTake(panel_ready_sem, timeout_ticks) != pdTRUE) return false;
+  return panel_ready;
+}
+
+bool lcd_panel_is_ready(void)
+{
+  return panel_ready;
+}
+
+void lcd_set_panel_ready_callback(lcd_panel_ready_cb_t cb)
+{
+  panel_ready_user_cb = cb;
+}
+
+/* --- LVGL core (no panel access; safe to run while the panel powers up) --- */
+void lcd_lvgl_core_Init(void)
+{
+  init_profile_begin(HOMEWIND_INIT_PHASE_LVGL_CORE);
   lv_init();
-  lv_color_t *buf1 = heap_caps_malloc(EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * sizeof(lv_color_t), MALLOC_CAP_DMA);
+  const size_t draw_buf_bytes = EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * sizeof(lv_color_t);
+  lv_color_t *buf1 = heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_DMA);
   assert(buf1);
-  lv_color_t *buf2 = heap_caps_malloc(EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT * sizeof(lv_color_t), MALLOC_CAP_DMA);
+  lv_color_t *buf2 = heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_DMA);
   assert(buf2);
+  mem_stats_account(HOMEWIND_MEM_DRAW_BUFFERS, 2 * draw_buf_bytes);
   lv_disp_draw_buf_init(&disp_buf, buf1, buf2, EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT);
   lv_disp_drv_init(&disp_drv);
   disp_drv.hor_res = EXAMPLE_LCD_H_RES;
@@ -101,7 +299,7 @@ void lcd_lvgl_Init(void)
   disp_drv.flush_cb = example_lvgl_flush_cb;
   disp_drv.rounder_cb = example_lvgl_rounder_cb;
   disp_drv.draw_buf = &disp_buf;
-  disp_drv.user_data = panel_handle;
+  disp_drv.user_data = amoled_panel_handle;
 #ifdef EXAMPLE_Rotate_90
   disp_drv.sw_rotate = 1;
   disp_drv.rotated = LV_DISP_ROT_270;
@@ -110,25 +308,60 @@ void lcd_lvgl_Init(void)
   g_display = disp;
   g_disp_drv = disp->driver;
 
+  // Panel still powering up: don't render until it can take pixels
+  if (!panel_ready) {
+    lv_timer_pause(disp->refr_timer);
+    panel_refr_held = true;
+  }
+
   static lv_indev_drv_t indev_drv;    // Input device driver (Touch)
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.disp = disp;
   indev_drv.read_cb = example_lvgl_touch_cb;
-  lv_indev_drv_register(&indev_drv);
+  touch_indev = lv_indev_drv_register(&indev_drv);
 
   const esp_timer_create_args_t lvgl_tick_timer_args = 
   {
     .callback = &example_increase_lvgl_tick,
     .name = "lvgl_tick"
   };
-  esp_timer_handle_t lvgl_tick_timer = NULL;
   ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
   ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
 
-  lvgl_mux = xSemaphoreCreateMutex(); //mutex semaphores
+  lvgl_mux = lcd_sem_create(true, LCD_STATIC(&lvgl_mux_buf)); //mutex semaphores
   assert(lvgl_mux);
-  xTaskCreate(example_lvgl_port_task, "LVGL", EXAMPLE_LVGL_TASK_STACK_SIZE, NULL, EXAMPLE_LVGL_TASK_PRIORITY, NULL);
+  init_profile_end(HOMEWIND_INIT_PHASE_LVGL_CORE);
+}
+
+/* --- LVGL task (first frame goes out as soon as the panel is ready) --- */
+void lcd_lvgl_start_task(void)
+{
+  if (!panel_ready) {
+    // Measures how long the prepared UI waits for the panel
+    init_profile_begin(HOMEWIND_INIT_PHASE_PANEL_WAIT);
+  }
+  lcd_task_create(example_lvgl_port_task, "LVGL", EXAMPLE_LVGL_TASK_STACK_SIZE, EXAMPLE_LVGL_TASK_PRIORITY,
+                  &lvgl_task_handle, LCD_STATIC(lvgl_task_stack), LCD_STATIC(&lvgl_task_tcb));
+}
+
+void lcd_lvgl_set_frame_hook(lcd_lvgl_frame_hook_t hook)
+{
+  lvgl_frame_hook = hook;
+}
+
+void lcd_lvgl_wake(void)
+{
+  if (lvgl_task_handle) {
+    xTaskNotifyGive(lvgl_task_handle);
+  }
+}
+
+void lcd_lvgl_Init(void)
+{
+  lcd_panel_Init();
+  lcd_lvgl_core_Init();
+  lcd_lvgl_start_task();
   
   // NOTE: UI initialization (homewind_create_screens, powersave_init) and
   // IMU rotation task are now handled by homewind_init() - not here in BSP layer.
@@ -160,17 +393,174 @@ void lcd_lvgl_unlock(void)
   example_lvgl_unlock();
 }
 
+static void lvgl_apply_anim_period(void)
+{
+  uint8_t fps = anim_fps_request ? anim_fps_request : LVGL_ANIM_FPS_MAX;
+  fps >>= anim_load_shift;
+  if (fps == 0) fps = 1;
+  uint32_t period = 1000 / fps;
+  if (period < EXAMPLE_LVGL_TICK_PERIOD_MS) period = EXAMPLE_LVGL_TICK_PERIOD_MS;
+  // Animating faster than the display refreshes only burns CPU
+  if (g_display && period < g_display->refr_timer->period) period = g_display->refr_timer->period;
+  if (period != anim_period_applied)
+  {
+    anim_period_applied = period;
+    lv_timer_set_period(lv_anim_get_timer(), period);
+  }
+}
+
+static void lvgl_frame_budget_update(uint32_t frame_us, uint32_t flush_us)
+{
+  if (frame_us > LVGL_FRAME_BUDGET_US + flush_us)
+  {
+    frames_in_budget = 0;
+    if (anim_load_shift < LVGL_ANIM_LOAD_SHIFT_MAX) anim_load_shift++;
+    for (uint8_t i = 0; i < low_prio_timer_count; i++)
+    {
+      lv_timer_t *timer = low_prio_timers[i];
+      if (timer->last_run == low_prio_deferred_at[i]) continue;  // Not run since the last deferral
+      lv_timer_reset(timer);  // Next run one full period from now
+      low_prio_deferred_at[i] = timer->last_run;
+    }
+    defer_frame_hook = !frame_hook_deferred;
+    if (touch_indev && touch_indev->driver->read_timer)
+    {
+      lv_timer_ready(touch_indev->driver->read_timer);
+    }
+  }
+  else if (anim_load_shift && ++frames_in_budget >= LVGL_FRAME_RECOVER_FRAMES)
+  {
+    frames_in_budget = 0;
+    anim_load_shift--;
+  }
+  lvgl_apply_anim_period();
+}
+
+void lcd_lvgl_set_anim_fps(uint8_t fps)
+{
+  anim_fps_request = (fps == 0 || fps > LVGL_ANIM_FPS_MAX) ? LVGL_ANIM_FPS_MAX : fps;
+}
+
+void lcd_lvgl_add_low_priority_timer(lv_timer_t *timer)
+{
+  if (!timer || low_prio_timer_count >= LVGL_LOW_PRIO_TIMERS_MAX) return;
+  low_prio_deferred_at[low_prio_timer_count] = timer->last_run - 1;
+  low_prio_timers[low_prio_timer_count++] = timer;
+}
+
+void lcd_lvgl_suspend(void)
+{
+  lvgl_suspend_req = true;
+}
+
+bool lcd_lvgl_is_suspended(void)
+{
+  return lvgl_suspended;
+}
+
+void lcd_lvgl_set_resume_callback(lcd_lvgl_resume_cb_t cb)
+{
+  lvgl_resume_cb = cb;
+}
+
+/* Panel off + sleep-in, no LVGL tick; returns true if a touch ended it */
+static bool lvgl_suspend_until_wake(void)
+{
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(amoled_panel_handle, false));
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_sleep(amoled_panel_handle, true));
+  esp_timer_stop(lvgl_tick_timer);
+
+  bool by_touch = false;
+  for (;;)
+  {
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LVGL_SUSPEND_TOUCH_POLL_MS)))
+    {
+      break;  // lcd_lvgl_wake(): new UI data
+    }
+    uint16_t x, y;
+    if (getTouch(&x, &y))
+    {
+      by_touch = true;
+      break;
+    }
+  }
+
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_sleep(amoled_panel_handle, false));
+  vTaskDelay(pdMS_TO_TICKS(LCD_SLEEP_OUT_DELAY_MS));
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_lcd_panel_disp_on_off(amoled_panel_handle, true));
+  esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000);
+  lvgl_suspended = false;
+  return by_touch;
+}
+
 static void example_lvgl_port_task(void *arg)
 {
   uint32_t task_delay_ms = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
+  heap_guard_watch_current_task();
   for(;;)
   {
     if (example_lvgl_lock(-1))
     {
+      if (panel_init_retry)
+      {
+        panel_init_retry = false;
+        lcd_panel_bring_up(amoled_panel_handle);
+        init_profile_end(HOMEWIND_INIT_PHASE_PANEL_INIT);
+        lcd_panel_set_ready(ESP_OK);
+      }
+      lcd_backlight_apply_pending();
+      if (panel_refr_held && panel_ready)
+      {
+        // Panel just came up: release the prepared frame immediately
+        panel_refr_held = false;
+        init_profile_end(HOMEWIND_INIT_PHASE_PANEL_WAIT);
+        lv_timer_resume(g_display->refr_timer);
+        lv_obj_invalidate(lv_scr_act());
+        lv_timer_ready(g_display->refr_timer);
+      }
+      int64_t frame_start = esp_timer_get_time();
+      event_trace_begin(HOMEWIND_TRACE_LVGL, 0);
+      if (lvgl_frame_hook && !defer_frame_hook)
+      {
+        // Apply state posted by other tasks before this frame renders
+        lvgl_frame_hook();
+      }
+      frame_hook_deferred = defer_frame_hook;
+      defer_frame_hook = false;
+      pass_flush_us = 0;
       task_delay_ms = lv_timer_handler();
+      uint32_t pass_us = (uint32_t)(esp_timer_get_time() - frame_start);
+      lvgl_frame_budget_update(pass_us, pass_flush_us);
+      perf_stats_lvgl_pass(frame_start, pass_us);
+      event_trace_end(HOMEWIND_TRACE_LVGL, pass_us);
+      if (lvgl_suspend_req)
+      {
+        lvgl_suspended = true;  // Set under the mutex: lcd_set_rotation() must not flush from here on
+      }
       
       example_lvgl_unlock();
     }
+    heap_guard_poll();
+    if (lvgl_suspend_req)
+    {
+      lvgl_suspend_req = false;
+      bool by_touch = lvgl_suspend_until_wake();
+      perf_stats_lvgl_resumed();
+      if (example_lvgl_lock(-1))
+      {
+        if (by_touch && touch_indev)
+        {
+          lv_indev_wait_release(touch_indev);  // The waking touch must not click a widget
+        }
+        lv_obj_invalidate(lv_scr_act());
+        if (lvgl_resume_cb)
+        {
+          lvgl_resume_cb(by_touch);
+        }
+        example_lvgl_unlock();
+      }
+      continue;
+    }
     if (task_delay_ms > EXAMPLE_LVGL_TASK_MAX_DELAY_MS)
     {
       task_delay_ms = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
@@ -179,7 +569,8 @@ static void example_lvgl_port_task(void *arg)
     {
       task_delay_ms = EXAMPLE_LVGL_TASK_MIN_DELAY_MS;
     }
-    vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
+    // Sleep until the next LVGL timer is due or lcd_lvgl_wake() is called
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(task_delay_ms));
   }
 }
 static void example_increase_lvgl_tick(void *arg)
@@ -190,17 +581,32 @@ static bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io,
 {
   lv_disp_drv_t *disp_driver = (lv_disp_drv_t *)user_ctx;
   lv_disp_flush_ready(disp_driver);
+  pass_flush_us += (uint32_t)(esp_timer_get_time() - flush_start_us);
+  perf_stats_flush_done();
+  event_trace_instant(HOMEWIND_TRACE_DMA_DONE, 0);
   return false;
 }
 static void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
   esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) drv->user_data;
+  if (!panel_ready)
+  {
+    // e.g. lv_refr_now() from lcd_set_rotation() while the panel powers up
+    lv_disp_flush_ready(drv);
+    return;
+  }
+  init_profile_mark_first_frame();
+  uint32_t bytes = lv_area_get_size(area) * sizeof(lv_color_t);
+  perf_stats_flush_begin(bytes, lv_disp_flush_is_last(drv));
   const int offsetx1 = area->x1 + 0x14;
   const int offsetx2 = area->x2 + 0x14;
   const int offsety1 = area->y1;
   const int offsety2 = area->y2;
 
+  event_trace_begin(HOMEWIND_TRACE_FLUSH, bytes);
+  flush_start_us = esp_timer_get_time();
   esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
+  event_trace_end(HOMEWIND_TRACE_FLUSH, bytes);
 }
 void example_lvgl_rounder_cb(struct _lv_disp_drv_t *disp_drv, lv_area_t *area)
 {
@@ -236,10 +642,13 @@ static void example_lvgl_touch_cb(lv_indev_drv_t *drv, lv_indev_data_t *data)
     return;
   }
   poll_counter = 0;
+  perf_stats_touch_poll();
   
   // Actually poll touch controller
   uint16_t tp_x, tp_y;
+  event_trace_begin(HOMEWIND_TRACE_TOUCH, 0);
   uint8_t win = getTouch(&tp_x, &tp_y);
+  event_trace_end(HOMEWIND_TRACE_TOUCH, win);
   if (win)
   {
     last_x = tp_x;
@@ -254,10 +663,16 @@ static void example_lvgl_touch_cb(lv_indev_drv_t *drv, lv_indev_data_t *data)
   data->point.x = last_x;
   data->point.y = last_y;
   data->state = last_state;
+  touch_pressed = (last_state == LV_INDEV_STATE_PRESSED);
 }
 
+bool lcd_touch_is_pressed(void)
+{
+  return touch_pressed;
+}
 
-esp_err_t set_amoled_backlight(uint8_t brig)
+
+static esp_err_t lcd_backlight_send(uint8_t brig)
 {
   uint32_t lcd_cmd = 0x51;
   lcd_cmd &= 0xff;
@@ -266,13 +681,78 @@ esp_err_t set_amoled_backlight(uint8_t brig)
   return esp_lcd_panel_io_tx_param(amoled_panel_io_handle, lcd_cmd, &brig,1);
 }
 
+// LVGL task: send a backlight write posted by another task (or before panel_ready)
+static void lcd_backlight_apply_pending(void)
+{
+  if (!panel_ready) return;
+  int16_t brightness = atomic_exchange(&pending_brightness, -1);
+  if (brightness >= 0)
+  {
+    lcd_backlight_send((uint8_t)brightness);
+  }
+}
+
+esp_err_t set_amoled_backlight(uint8_t brig)
+{
+  if (panel_ready && lvgl_task_handle && xTaskGetCurrentTaskHandle() == lvgl_task_handle)
+  {
+    // Same task as the flushes: tx_param queues behind the pending color data
+    atomic_store(&pending_brightness, -1);
+    return lcd_backlight_send(brig);
+  }
+  atomic_store(&pending_brightness, brig);
+  if (!lvgl_suspended)
+  {
+    lcd_lvgl_wake();  // Panel off: sent on resume, a backlight write must not wake the panel
+  }
+  return ESP_OK;
+}
+
+static lcd_rotation_cb_t rotation_cb = NULL;
+
+void lcd_set_rotation_callback(lcd_rotation_cb_t cb)
+{
+  rotation_cb = cb;
+}
+
+// Portrait <-> landscape: give every screen the new resolution in place.
+// lv_disp_drv_update() would also mark the whole object tree for relayout;
+// LV_EVENT_SIZE_CHANGED only re-evaluates the direct children of each screen.
+static void lvgl_resize_screens(void)
+{
+  lv_coord_t w = lv_disp_get_hor_res(g_display);
+  lv_coord_t h = lv_disp_get_ver_res(g_display);
+  for (uint32_t i = 0; i < g_display->screen_cnt; i++)
+  {
+    lv_obj_t *scr = g_display->screens[i];
+    lv_area_t prev;
+    lv_obj_get_coords(scr, &prev);
+    lv_area_set_width(&scr->coords, w);
+    lv_area_set_height(&scr->coords, h);
+    lv_event_send(scr, LV_EVENT_SIZE_CHANGED, &prev);
+  }
+}
+
 void lcd_set_rotation(lv_disp_rot_t rotation) {
     if (g_display && g_display->driver) {
         // Lock LVGL before modifying
         if (example_lvgl_lock(100)) {
+            lv_disp_rot_t prev = (lv_disp_rot_t)g_display->driver->rotated;
+            if (rotation == prev) {
+                example_lvgl_unlock();
+                return;
+            }
+
             // Modify the driver's rotation settings
             g_display->driver->sw_rotate = 1;
             g_display->driver->rotated = rotation;
+            if ((prev ^ rotation) & 1) {
+                lvgl_resize_screens();
+            }
+            // UI moves its widgets to the cached layout of this orientation
+            if (rotation_cb) {
+                rotation_cb(rotation);
+            }
             
             // Only invalidate if screen exists (safety check)
             lv_obj_t* screen = lv_scr_act();
@@ -280,72 +760,207 @@ void lcd_set_rotation(lv_disp_rot_t rotation) {
                 lv_obj_invalidate(screen);
             }
             
-            // Trigger a refresh
-            lv_refr_now(g_display);
+            // Trigger a refresh (suspended: the panel is in sleep-in, resume redraws)
+            if (!lvgl_suspended) {
+                lv_refr_now(g_display);
+            }
             
             example_lvgl_unlock();
         }
     }
 }
 
+static lcd_imu_motion_cb_t imu_motion_cb = NULL;
+
+void lcd_set_imu_motion_callback(lcd_imu_motion_cb_t cb)
+{
+  imu_motion_cb = cb;
+}
+
+static lcd_imu_face_down_cb_t imu_face_down_cb = NULL;
+
+void lcd_set_imu_face_down_callback(lcd_imu_face_down_cb_t cb)
+{
+  imu_face_down_cb = cb;
+}
+
+static volatile lcd_imu_status_t imu_status = LCD_IMU_STATUS_NONE;
+static lcd_imu_status_cb_t imu_status_cb = NULL;
+
+void lcd_set_imu_status_callback(lcd_imu_status_cb_t cb)
+{
+  imu_status_cb = cb;
+}
+
+lcd_imu_status_t lcd_get_imu_status(void)
+{
+  return imu_status;
+}
+
+static void imu_set_status(lcd_imu_status_t status)
+{
+  imu_status = status;
+  if (imu_status_cb) imu_status_cb(status);
+}
+
 #ifdef QMI8658_SLAVE_ADDR_L
 // IMU Rotation Task Configuration
-#define IMU_ROTATION_CHECK_INTERVAL_MS  200   // Check every 200ms (5Hz) - sufficient for rotation
-#define IMU_ROTATION_HYSTERESIS         0.3f  // Hysteresis band to prevent flicker at threshold
-#define IMU_ROTATION_STABLE_COUNT       2     // Require N consecutive readings before rotation
+// Accelerometer runs at 21 Hz (low power) into the FIFO; the task wakes once per watermark
+// and drains the whole batch in one burst instead of one I2C read per sample. Each batch
+// mean goes through imu_rotation_process() (tilt fusion, face-down, debounced orientation),
+// the same code the host replay runner in extras/imu_replay executes.
+#define IMU_FIFO_WATERMARK              4     // Samples per batch (~190ms at 21 Hz, 128ms at 31.25 Hz), 7 I2C transactions each
+#if IMU_FUSION_USE_GYRO
+#define IMU_SENSOR_MODE                 QMI8658_CFG_FUSION
+#define IMU_FIFO_PERIOD_MS              ((IMU_FIFO_WATERMARK * 100000) / 3125)
+#else
+#define IMU_SENSOR_MODE                 QMI8658_CFG_LOW_POWER
+#define IMU_FIFO_PERIOD_MS              ((IMU_FIFO_WATERMARK * 1000) / 21)
+#endif
+
+static TaskHandle_t imu_task_handle = NULL;
+static uint32_t imu_stack_free_min = 0;  // High-water mark saved when the task ends
+#if LCD_STATIC_ALLOC
+static StackType_t imu_task_stack[EXAMPLE_IMU_TASK_STACK_SIZE];
+static StaticTask_t imu_task_tcb;
+#endif
+
+// Probe, on-demand calibration (~2.3 s of sensor delays) and optional self-test, all in the
+// IMU task so none of it sits on the path to the first frame. Anything but READY ends the task.
+static lcd_imu_status_t imu_bring_up(void)
+{
+    init_profile_begin(HOMEWIND_INIT_PHASE_IMU);
+    bool found = qmi8658_init();
+    init_profile_end(HOMEWIND_INIT_PHASE_IMU);
+    if (!found)
+    {
+        return LCD_IMU_STATUS_NOT_FOUND;
+    }
+#if defined(QMI8658_SOFT_SELFTEST)
+    if (!qmi8658_do_selftest())
+    {
+        return LCD_IMU_STATUS_SELFTEST_FAILED;
+    }
+#endif
+    return LCD_IMU_STATUS_READY;
+}
+
+#if EXAMPLE_PIN_NUM_IMU_INT >= 0
+static void IRAM_ATTR imu_int_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(imu_task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Any-motion + no-motion on INT1 (accelerometer low power unless IMU_FUSION_USE_GYRO). Called from the IMU task.
+static bool imu_motion_int_init(void)
+{
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << EXAMPLE_PIN_NUM_IMU_INT,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    if (gpio_config(&io_conf) != ESP_OK) return false;
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;  // Already installed is fine
+    if (gpio_isr_handler_add((gpio_num_t)EXAMPLE_PIN_NUM_IMU_INT, imu_int_isr, NULL) != ESP_OK) return false;
+
+    qmi8658_enable_amd(1, qmi8658_Int1, IMU_SENSOR_MODE);
+    qmi8658_enable_no_motion(1);
+    qmi8658_config_fifo(IMU_FIFO_WATERMARK, qmi8658_Fifo_16, qmi8658_Fifo_Stream, qmi8658_Int1);
+    return true;
+}
+#else
+static bool imu_motion_int_init(void) { return false; }
+#endif
 
 static void example_imu_rotation_task(void *arg)
 {
-    float acc[3];
-    float gyro[3];
-    static lv_disp_rot_t current_rotation = (lv_disp_rot_t)0;
-    static lv_disp_rot_t pending_rotation = (lv_disp_rot_t)0;
-    static uint8_t stable_count = 0;
+    int16_t acc[3];
+    int16_t gyro[3];
+    static imu_rotation_t rot;
     
-    // Wait for display and screens to be fully initialized
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    lcd_imu_status_t status = imu_bring_up();
+    if (status != LCD_IMU_STATUS_READY)
+    {
+        // Mark first: once the status says the task ended, lcd_get_task_stack_info() reads it
+        imu_stack_free_min = uxTaskGetStackHighWaterMark(NULL);
+        imu_set_status(status);
+        vTaskDelete(NULL);
+        return;
+    }
+    imu_set_status(status);
+    heap_guard_watch_current_task();
+
+    // Rotation decisions wait for the display (imu_rotation_process(.., decide)), not a fixed delay
+    // With the motion interrupt the task drains the FIFO only while the device moves
+    bool motion_int = imu_motion_int_init();
+    bool moving = true;
+    if (!motion_int)
+    {
+        qmi8658_config_reg(IMU_SENSOR_MODE);
+        qmi8658_config_fifo(IMU_FIFO_WATERMARK, qmi8658_Fifo_16, qmi8658_Fifo_Stream, qmi8658_Int_none);
+    }
+    uint16_t acc_lsb = qmi8658_get_acc_lsb();
+    uint16_t odr_dhz = qmi8658_get_odr_dhz();
+    imu_rotation_init(&rot, 0, acc_lsb, IMU_FUSION_USE_GYRO ? qmi8658_get_gyro_lsb() : 0);
     
     for(;;)
     {
-        // Only proceed if display is ready and screen exists
-        if (g_display && g_display->driver && lv_scr_act() != NULL) {
-            qmi8658_read_xyz(acc, gyro);
-            
-            // Determine target rotation with hysteresis
-            // Use higher threshold to enter new state, lower to exit (prevents oscillation)
-            lv_disp_rot_t target_rotation = current_rotation;
-            
-            if (current_rotation == (lv_disp_rot_t)0) {
-                // Currently normal: need stronger signal to rotate to 180°
-                if (acc[0] < g_imu_tilt_left_threshold - IMU_ROTATION_HYSTERESIS) {
-                    target_rotation = LV_DISP_ROT_180;
+        if (motion_int)
+        {
+            // At rest: no I2C traffic until the any-motion interrupt.
+            // Moving: woken by the FIFO watermark (timeout = fallback for a missed edge).
+            uint32_t irq = ulTaskNotifyTake(pdTRUE, moving ? pdMS_TO_TICKS(2 * IMU_FIFO_PERIOD_MS)
+                                                           : portMAX_DELAY);
+            if (irq)
+            {
+                uint8_t status = qmi8658_readStatus1();
+                if ((status & QMI8658_STATUS1_ANY_MOTION) && !moving)
+                {
+                    moving = true;
+                    qmi8658_set_fifo_int(qmi8658_Int1);
+                    // A knock on the table while the screen faces down is not a pick-up;
+                    // lifting it is reported below once the gravity vector turns
+                    if (!imu_fusion_is_face_down() && imu_motion_cb) imu_motion_cb();
                 }
-            } else {
-                // Currently 180°: need stronger signal to rotate to normal
-                if (acc[0] > g_imu_tilt_right_threshold + IMU_ROTATION_HYSTERESIS) {
-                    target_rotation = (lv_disp_rot_t)0;
+                if (status & QMI8658_STATUS1_NO_MOTION)
+                {
+                    // Park the watermark interrupt on the unconnected INT2
+                    moving = false;
+                    qmi8658_set_fifo_int(qmi8658_Int2);
                 }
             }
-            
-            // Require stable readings before actually rotating (debounce)
-            if (target_rotation != current_rotation) {
-                if (target_rotation == pending_rotation) {
-                    stable_count++;
-                    if (stable_count >= IMU_ROTATION_STABLE_COUNT) {
-                        lcd_set_rotation(target_rotation);
-                        current_rotation = target_rotation;
-                        stable_count = 0;
-                    }
-                } else {
-                    pending_rotation = target_rotation;
-                    stable_count = 1;
-                }
-            } else {
-                stable_count = 0;
-            }
+            if (!moving) continue;
+        }
+        else
+        {
+            vTaskDelay(pdMS_TO_TICKS(IMU_FIFO_PERIOD_MS));
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(IMU_ROTATION_CHECK_INTERVAL_MS));
+
+        // Drain the batch even before the display is up so the FIFO holds fresh samples
+        event_trace_begin(HOMEWIND_TRACE_IMU_READ, 0);
+        uint16_t n = qmi8658_read_fifo_raw_mean(acc, gyro);
+        event_trace_end(HOMEWIND_TRACE_IMU_READ, n);
+        if (n == 0) continue;
+        if (g_imu_thresholds_changed)
+        {
+            g_imu_thresholds_changed = false;
+            imu_rotation_set_thresholds(&rot, g_imu_tilt_right_threshold, g_imu_tilt_left_threshold, acc_lsb);
+        }
+        rot.four_way = g_imu_four_way;
+
+        // Only decide once the display is ready and a screen exists
+        bool display_ready = g_display && g_display->driver && lv_scr_act() != NULL;
+        uint8_t evt = imu_rotation_process(&rot, acc, IMU_FUSION_USE_GYRO ? gyro : NULL,
+                                           imu_rotation_batch_ms(n, odr_dhz), display_ready);
+        if ((evt & IMU_ROTATION_EVT_FACE_DOWN) && imu_face_down_cb) imu_face_down_cb();
+        // Lifted: counts as motion after rest (also without the INT pin)
+        if ((evt & IMU_ROTATION_EVT_LIFTED) && imu_motion_cb) imu_motion_cb();
+        if (evt & IMU_ROTATION_EVT_ROTATE) lcd_set_rotation((lv_disp_rot_t)rot.current);
     }
 }
 
@@ -353,6 +968,17 @@ static void example_imu_rotation_task(void *arg)
 void lcd_set_imu_tilt_thresholds(float tilt_right, float tilt_left) {
     g_imu_tilt_right_threshold = tilt_right;
     g_imu_tilt_left_threshold = tilt_left;
+    g_imu_thresholds_changed = true;
+}
+
+// Function to enable 90°/270° (landscape) detection
+void lcd_set_imu_four_way(bool enable) {
+    g_imu_four_way = enable;
+}
+
+// Function to read the fused tilt angles (0.1°)
+bool lcd_get_imu_tilt(int16_t *pitch_deg10, int16_t *roll_deg10) {
+    return imu_fusion_get_tilt(pitch_deg10, roll_deg10);
 }
 
 // Function to get current IMU rotation tilt thresholds
@@ -361,16 +987,45 @@ void lcd_get_imu_tilt_thresholds(float *tilt_right, float *tilt_left) {
     if (tilt_left) *tilt_left = g_imu_tilt_left_threshold;
 }
 
-// Public API: Initialize IMU and start rotation task
-// Returns true if successful, false if IMU not present/init failed
+// Public API: start the IMU task; it probes the QMI8658 itself and reports via the status callback
 bool lcd_start_imu_rotation_task(void) {
-    // Initialize QMI8658 IMU
-    if (qmi8658_init()) {
-        // Create IMU rotation task if initialization succeeded
-        // Task has internal 2s delay to wait for display to be fully ready
-        xTaskCreate(example_imu_rotation_task, "IMU_Rotation", 4096, NULL, 1, NULL);
-        return true;
+    if (imu_status != LCD_IMU_STATUS_NONE) return true;  // Already started
+    imu_status = LCD_IMU_STATUS_STARTING;
+    if (!lcd_task_create(example_imu_rotation_task, "IMU_Rotation", EXAMPLE_IMU_TASK_STACK_SIZE,
+                         EXAMPLE_IMU_TASK_PRIORITY, &imu_task_handle,
+                         LCD_STATIC(imu_task_stack), LCD_STATIC(&imu_task_tcb))) {
+        imu_status = LCD_IMU_STATUS_NONE;
+        return false;
     }
-    return false;
+    return true;
+}
+#endif
+
+/* --- Task stack telemetry --- */
+bool lcd_get_task_stack_info(lcd_task_id_t task, lcd_task_stack_info_t *info)
+{
+  if (!info) return false;
+  info->static_alloc = LCD_STATIC_ALLOC;
+  switch (task) {
+    case LCD_TASK_LVGL:
+      if (!lvgl_task_handle) return false;
+      info->name = "LVGL";
+      info->stack_size = EXAMPLE_LVGL_TASK_STACK_SIZE;
+      info->stack_free_min = uxTaskGetStackHighWaterMark(lvgl_task_handle);
+      info->running = true;
+      return true;
+#ifdef QMI8658_SLAVE_ADDR_L
+    case LCD_TASK_IMU: {
+      lcd_imu_status_t status = imu_status;
+      if (status == LCD_IMU_STATUS_NONE || !imu_task_handle) return false;
+      info->name = "IMU_Rotation";
+      info->stack_size = EXAMPLE_IMU_TASK_STACK_SIZE;
+      info->running = (status == LCD_IMU_STATUS_STARTING || status == LCD_IMU_STATUS_READY);
+      info->stack_free_min = info->running ? uxTaskGetStackHighWaterMark(imu_task_handle) : imu_stack_free_min;
+      return true;
+    }
+#endif
+    default:
+      return false;
+  }
 }
-#endif
\ No newline at end of file
@@ -29,27 +29,115 @@ static void example_lvgl_port_task(void *arg);
 static void example_lvgl_unlock(void);
 static bool example_lvgl_lock(int timeout_ms);
 void lcd_lvgl_Init(void);
+/* Split init phases (lcd_lvgl_Init() = panel + LVGL core + task) */
+void lcd_panel_Init(void);
+void lcd_lvgl_core_Init(void);
+void lcd_lvgl_start_task(void);
+/** Panel ready callback (esp_timer task context; LVGL task if a failed async sequence was redone blocking). */
+typedef void (*lcd_panel_ready_cb_t)(esp_err_t result);
+/**
+ * Start panel bring-up without blocking (reset + init commands driven by esp_timer).
+ * LVGL can be initialized and the LVGL task started right away: rendering is held
+ * until the panel is ready, then the first frame is flushed immediately.
+ * Returns false if it had to fall back to the blocking sequence.
+ */
+bool lcd_panel_Init_async(void);
+/** Wait for lcd_panel_Init_async(). timeout_ms: -1 = wait forever. */
+bool lcd_panel_wait_ready(int timeout_ms);
+bool lcd_panel_is_ready(void);
+/** Called once the panel finished its init sequence (set before lcd_panel_Init_async()). */
+void lcd_set_panel_ready_callback(lcd_panel_ready_cb_t cb);
+/** Wake the LVGL task early (e.g. after new UI data); safe from any task. */
+void lcd_lvgl_wake(void);
+/** Hook run by the LVGL task (mutex held) right before each lv_timer_handler(). */
+typedef void (*lcd_lvgl_frame_hook_t)(void);
+void lcd_lvgl_set_frame_hook(lcd_lvgl_frame_hook_t hook);
+/** Cap the animation frame rate (e.g. per power state); 0 = LVGL_ANIM_FPS_MAX. Safe from any task.
+ *  Never faster than the display refresh period; frame overruns lower the effective rate
+ *  further until frames fit the budget again. */
+void lcd_lvgl_set_anim_fps(uint8_t fps);
+/** Register an lv_timer that is pushed back (at most one period per run) when a frame overruns
+ *  its budget (LVGL context). Not for timers that carry a deadline. */
+void lcd_lvgl_add_low_priority_timer(lv_timer_t *timer);
+/** Resume callback (LVGL task, mutex held). by_touch: woken by touch, else by lcd_lvgl_wake(). */
+typedef void (*lcd_lvgl_resume_cb_t)(bool by_touch);
+/**
+ * Suspend LVGL after the current pass (LVGL context): display off + sleep-in, tick timer
+ * stopped, port task blocked. A touch or lcd_lvgl_wake() restores the panel and LVGL.
+ */
+void lcd_lvgl_suspend(void);
+bool lcd_lvgl_is_suspended(void);
+void lcd_lvgl_set_resume_callback(lcd_lvgl_resume_cb_t cb);
+/** True while a finger is on the panel (as last reported to LVGL). LVGL task only. */
+bool lcd_touch_is_pressed(void);
 /** Lock LVGL mutex before calling LVGL from another task (e.g. setup/loop). timeout_ms: -1 = wait forever. */
 bool lcd_lvgl_lock(int timeout_ms);
 /** Unlock LVGL mutex after lcd_lvgl_lock(). */
 void lcd_lvgl_unlock(void);
 static void example_lvgl_touch_cb(lv_indev_drv_t *drv, lv_indev_data_t *data);
+/** Backlight 0..255; safe from any task (other tasks post it, the LVGL task sends it between flushes). */
 esp_err_t set_amoled_backlight(uint8_t brig);
 void lcd_set_rotation(lv_disp_rot_t rotation);
+/** Rotation callback (caller's task, LVGL mutex held), after the screens took the new resolution. */
+typedef void (*lcd_rotation_cb_t)(lv_disp_rot_t rotation);
+void lcd_set_rotation_callback(lcd_rotation_cb_t cb);
+
+/** IMU motion callback (IMU task context): the device was moved after resting. */
+typedef void (*lcd_imu_motion_cb_t)(void);
+void lcd_set_imu_motion_callback(lcd_imu_motion_cb_t cb);
+/** IMU face-down callback (IMU task context): the screen has faced the ground for a moment. */
+typedef void (*lcd_imu_face_down_cb_t)(void);
+void lcd_set_imu_face_down_callback(lcd_imu_face_down_cb_t cb);
+/* --- Task stack telemetry --- */
+typedef enum {
+    LCD_TASK_LVGL = 0,   /* example_lvgl_port_task, EXAMPLE_LVGL_TASK_STACK_SIZE */
+    LCD_TASK_IMU,        /* IMU rotation task, EXAMPLE_IMU_TASK_STACK_SIZE */
+    LCD_TASK_COUNT
+} lcd_task_id_t;
+
+typedef struct {
+    const char *name;
+    uint32_t stack_size;       /* Bytes */
+    uint32_t stack_free_min;   /* High-water mark: least free stack seen so far, bytes */
+    bool running;              /* false: the task ended (IMU not found); free_min is its final mark */
+    bool static_alloc;         /* LCD_STATIC_ALLOC build */
+} lcd_task_stack_info_t;
+
+/**
+ * @brief Stack usage of a library task (any task)
+ * @return false if the task was never started (or has no QMI8658 support)
+ */
+bool lcd_get_task_stack_info(lcd_task_id_t task, lcd_task_stack_info_t *info);
+
+/** IMU bring-up state; lcd_start_imu_rotation_task() probes the sensor in the IMU task. */
+typedef enum {
+    LCD_IMU_STATUS_NONE = 0,          /* Task not started */
+    LCD_IMU_STATUS_STARTING,          /* Probe / calibration / self-test running */
+    LCD_IMU_STATUS_READY,             /* Rotation running */
+    LCD_IMU_STATUS_NOT_FOUND,         /* No QMI8658 answered; task ended */
+    LCD_IMU_STATUS_SELFTEST_FAILED    /* QMI8658_SOFT_SELFTEST failed; task ended */
+} lcd_imu_status_t;
+/** IMU status callback (IMU task context), called once with the bring-up result. */
+typedef void (*lcd_imu_status_cb_t)(lcd_imu_status_t status);
+void lcd_set_imu_status_callback(lcd_imu_status_cb_t cb);
+lcd_imu_status_t lcd_get_imu_status(void);
 
 #ifdef QMI8658_SLAVE_ADDR_L
 void lcd_set_imu_tilt_thresholds(float tilt_right, float tilt_left);
 void lcd_get_imu_tilt_thresholds(float *tilt_right, float *tilt_left);
+/** Also rotate to 90°/270° (landscape) when the Y axis dominates. Default off (0°/180° only). */
+void lcd_set_imu_four_way(bool enable);
+/** Fused tilt angles in 0.1° (pitch about Y, roll about X); false before the first IMU batch. */
+bool lcd_get_imu_tilt(int16_t *pitch_deg10, int16_t *roll_deg10);
 /**
- * @brief Initialize and start the IMU rotation task
+ * @brief Start the IMU rotation task
  * 
- * This function initializes the QMI8658 IMU sensor and starts a background
- * task that automatically adjusts display rotation based on accelerometer data.
+ * Returns right away: the task probes and configures the QMI8658 (and runs
+ * the self-test with QMI8658_SOFT_SELFTEST) before it starts adjusting the
+ * display rotation. The result arrives through lcd_set_imu_status_callback().
  * 
- * @return true if IMU was initialized and task started successfully
- * @return false if IMU initialization failed (hardware not present)
+ * @return true if the task runs (or already ran), false if it could not be created
  * 
- * @note Only available if QMI8658 hardware is detected
  * @note This function is called automatically by homewind_init()
  */
 bool lcd_start_imu_rotation_task(void);
@@ -25,6 +25,50 @@
 #define EXAMPLE_LVGL_TASK_MIN_DELAY_MS 5                          // Min delay (match tick period)
 #define EXAMPLE_LVGL_TASK_STACK_SIZE   (4 * 1024)                 // Task stack size
 #define EXAMPLE_LVGL_TASK_PRIORITY     2                          // Task priority
+#define EXAMPLE_IMU_TASK_STACK_SIZE    (4 * 1024)                 // IMU rotation task stack
+#define EXAMPLE_IMU_TASK_PRIORITY      1
+
+// 1 = library tasks, the LVGL mutex and the panel-ready semaphore use static RAM
+// (xTaskCreateStatic / xSemaphoreCreate*Static) instead of the FreeRTOS heap.
+// Size the stacks from lcd_get_task_stack_info() high-water marks.
+#define LCD_STATIC_ALLOC               0
+
+// 1 = zero heap after init: the LVGL task and the IMU task must not call the system heap once
+// homewind_init() returned. Pair with extras/lv_conf_arena.h (LVGL objects, styles and label
+// text from one pool taken at lv_init()); stray calls are reported via homewind_set_alloc_hook()
+// when the IDF heap hooks are enabled (CONFIG_HEAP_USE_HOOKS).
+#define HOMEWIND_ZERO_HEAP             0
+
+// 1 = runtime performance counters (homewind_get_perf_stats()): frame/render/flush timing,
+// LVGL CPU share, touch polls, I2C errors, power-state residency. 0 compiles the hooks out.
+#define HOMEWIND_PERF_STATS            1
+
+// 1 = event trace hooks (homewind_trace_start(), Chrome trace JSON for chrome://tracing or
+// ui.perfetto.dev). Costs nothing but a check while no trace runs; 0 compiles the hooks out.
+#define HOMEWIND_EVENT_TRACE           1
+
+// Frame budget: a pass of lv_timer_handler() (incl. UI apply) longer than this plus the measured
+// flush DMA time of that pass is an overrun. Overruns halve the animation rate (down to 1/4),
+// defer low-priority timers (once per run) and UI updates (never two passes in a row) and make
+// the touch read due first; LVGL_FRAME_RECOVER_FRAMES good passes undo one step.
+#define LVGL_FRAME_BUDGET_US           16000
+#define LVGL_FRAME_RECOVER_FRAMES      30
+#define LVGL_ANIM_FPS_MAX              60                         // Animation timer cap in ACTIVE state (and the refresh period)
+#define LVGL_ANIM_LOAD_SHIFT_MAX       2
+#define LVGL_LOW_PRIO_TIMERS_MAX       4
+
+// Suspended LVGL (panel off): touch is polled directly at this interval, the SH8601 needs
+// LCD_SLEEP_OUT_DELAY_MS after sleep-out before display-on
+#define LVGL_SUSPEND_TOUCH_POLL_MS     150
+#define LCD_SLEEP_OUT_DELAY_MS         120
+
+// QMI8658 INT1 (any-motion / no-motion). With the pin wired the IMU task sleeps until the
+// device is moved and the accelerometer runs in low-power mode; -1 keeps 5 Hz polling.
+#define EXAMPLE_PIN_NUM_IMU_INT        (-1)
+
+// Tilt fusion: 1 = also run the gyro (accel + gyro at 31.25 Hz into the FIFO) so vibration
+// and short knocks do not move the gravity vector; 0 = accelerometer-only low-power mode.
+#define IMU_FUSION_USE_GYRO            0
 
 #define I2C_ADDR_FT3168 0x38
 #define EXAMPLE_PIN_NUM_TOUCH_SCL 48
@@ -6,4 +6,9 @@
 #include "../extras/lv_conf_psram.h"
 #endif
 
+/* Optional: fixed LVGL arena (zero heap after init) when HOMEWIND_LVGL_ARENA is defined */
+#ifdef HOMEWIND_LVGL_ARENA
+#include "../extras/lv_conf_arena.h"
+#endif
+
 #endif /* LV_CONF_PSRAM_AUTO_H */
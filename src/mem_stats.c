@@ -0,0 +1,226 @@
+// mem_stats.c
+#include "mem_stats.h"
+#include "lcd_bsp.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include <stdatomic.h>
+
+LV_FONT_DECLARE(lv_font_inter_black_64);
+LV_FONT_DECLARE(lv_font_inter_bold_14);
+LV_FONT_DECLARE(lv_font_inter_bold_24);
+LV_FONT_DECLARE(lv_font_icon_36);
+LV_FONT_DECLARE(lv_font_icon_56);
+
+static const char *const subsys_names[HOMEWIND_MEM_SUBSYS_COUNT] = {
+    "draw_buffers",
+    "screens",
+    "fonts",
+    "qr",
+    "history",
+    "tasks",
+};
+
+#define HEAP_CLASS_COUNT 3
+static const uint32_t heap_classes[HEAP_CLASS_COUNT] = {
+    MALLOC_CAP_INTERNAL,
+    MALLOC_CAP_SPIRAM,
+    MALLOC_CAP_DMA,
+};
+
+/* --- Fixed footprint (written while the library starts up) --- */
+static uint32_t subsys_bytes[HOMEWIND_MEM_SUBSYS_COUNT];
+static uint32_t lvgl_mark = 0;
+static uint32_t fonts_bytes = 0;
+
+/* --- Sampler snapshot (LVGL task writes, any task reads) ---
+ * Double buffered: the sampler fills the idle slot and then publishes it, so
+ * a reader only sees a torn copy if it stalls for a whole sample period. */
+typedef struct {
+    homewind_lvgl_mem_stats_t lvgl;
+    uint32_t min_largest[HEAP_CLASS_COUNT];
+    uint32_t samples;
+} mem_sample_t;
+
+static mem_sample_t sample_slots[2];
+static _Atomic uint8_t sample_slot = 0;
+static lv_timer_t *sample_timer = NULL;
+
+/* ============================================================================
+ * Measurement
+ * ============================================================================ */
+
+static uint32_t lvgl_used_bytes(void)
+{
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+#else
+    /* LVGL allocates from the system heap: whole-heap delta, other tasks blur it */
+    return (uint32_t)(heap_caps_get_total_size(MALLOC_CAP_8BIT) - heap_caps_get_free_size(MALLOC_CAP_8BIT));
+#endif
+}
+
+/* Flash taken by a lv_font_conv font: glyph bitmaps (they are stored in glyph id
+ * order, so the last glyph ends the array) plus the glyph descriptors. */
+static uint32_t font_flash_bytes(const lv_font_t *font)
+{
+    const lv_font_fmt_txt_dsc_t *dsc = (const lv_font_fmt_txt_dsc_t *)font->dsc;
+    uint32_t glyphs = 0;
+
+    for (uint16_t i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cmap = &dsc->cmaps[i];
+        uint32_t count = 0;
+        switch (cmap->type) {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+                count = cmap->range_length;
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+                count = cmap->list_length;
+                break;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                for (uint16_t k = 0; k < cmap->range_length; k++) {
+                    uint32_t ofs = ((const uint8_t *)cmap->glyph_id_ofs_list)[k];
+                    if (ofs + 1 > count) count = ofs + 1;
+                }
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+                for (uint16_t k = 0; k < cmap->list_length; k++) {
+                    uint32_t ofs = ((const uint16_t *)cmap->glyph_id_ofs_list)[k];
+                    if (ofs + 1 > count) count = ofs + 1;
+                }
+                break;
+        }
+        if (cmap->glyph_id_start + count > glyphs) glyphs = cmap->glyph_id_start + count;
+    }
+    if (glyphs == 0) return 0;
+
+    /* Uncompressed size of the last glyph (an upper bound for compressed fonts) */
+    const lv_font_fmt_txt_glyph_dsc_t *last = &dsc->glyph_dsc[glyphs - 1];
+    uint32_t bitmap = last->bitmap_index + ((uint32_t)last->box_w * last->box_h * dsc->bpp + 7) / 8;
+    return bitmap + glyphs * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+}
+
+static uint32_t fonts_flash_bytes(void)
+{
+    if (fonts_bytes == 0) {
+        static const lv_font_t *const fonts[] = {
+            &lv_font_inter_black_64,
+            &lv_font_inter_bold_14,
+            &lv_font_inter_bold_24,
+            &lv_font_icon_36,
+            &lv_font_icon_56,
+        };
+        uint32_t total = 0;
+        for (size_t i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+            total += font_flash_bytes(fonts[i]);
+        }
+        fonts_bytes = total;
+    }
+    return fonts_bytes;
+}
+
+static uint32_t task_stack_bytes(void)
+{
+    uint32_t total = 0;
+    lcd_task_stack_info_t info;
+    for (int task = 0; task < LCD_TASK_COUNT; task++) {
+        if (lcd_get_task_stack_info((lcd_task_id_t)task, &info) && info.running) {
+            total += info.stack_size;
+        }
+    }
+    return total;
+}
+
+/* --- Watermark sampler (LVGL task, low-priority timer) --- */
+static void mem_sample_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    uint8_t cur = atomic_load_explicit(&sample_slot, memory_order_relaxed);
+    mem_sample_t *next = &sample_slots[cur ^ 1];
+    *next = sample_slots[cur];
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    next->lvgl.total = mon.total_size;
+    next->lvgl.free = mon.free_size;
+    next->lvgl.largest = mon.free_biggest_size;
+    next->lvgl.max_used = mon.max_used;
+    next->lvgl.used_pct = mon.used_pct;
+    next->lvgl.frag_pct = mon.frag_pct;
+    if (mon.frag_pct > next->lvgl.max_frag_pct) next->lvgl.max_frag_pct = mon.frag_pct;
+#endif
+
+    for (int i = 0; i < HEAP_CLASS_COUNT; i++) {
+        if (heap_caps_get_total_size(heap_classes[i]) == 0) continue;
+        uint32_t largest = heap_caps_get_largest_free_block(heap_classes[i]);
+        if (next->samples == 0 || largest < next->min_largest[i]) next->min_largest[i] = largest;
+    }
+    next->samples++;
+    atomic_store_explicit(&sample_slot, cur ^ 1, memory_order_release);
+}
+
+/* ============================================================================
+ * Internal API
+ * ============================================================================ */
+
+void mem_stats_account(homewind_mem_subsys_t subsys, uint32_t bytes)
+{
+    if (subsys < HOMEWIND_MEM_SUBSYS_COUNT) subsys_bytes[subsys] += bytes;
+}
+
+void mem_stats_lvgl_begin(void)
+{
+    lvgl_mark = lvgl_used_bytes();
+}
+
+void mem_stats_lvgl_end(homewind_mem_subsys_t subsys)
+{
+    uint32_t used = lvgl_used_bytes();
+    if (used > lvgl_mark) mem_stats_account(subsys, used - lvgl_mark);
+}
+
+void mem_stats_start(void)
+{
+    if (sample_timer) return;
+    sample_timer = lv_timer_create(mem_sample_cb, HOMEWIND_MEM_SAMPLE_MS, NULL);
+    lcd_lvgl_add_low_priority_timer(sample_timer);
+    mem_sample_cb(NULL);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void homewind_get_mem_stats(homewind_mem_stats_t *stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+
+    uint8_t slot = atomic_load_explicit(&sample_slot, memory_order_acquire);
+    mem_sample_t sample = sample_slots[slot];
+
+    homewind_heap_stats_t *heaps[HEAP_CLASS_COUNT] = { &stats->internal, &stats->psram, &stats->dma };
+    for (int i = 0; i < HEAP_CLASS_COUNT; i++) {
+        homewind_heap_stats_t *h = heaps[i];
+        h->total = heap_caps_get_total_size(heap_classes[i]);
+        if (h->total == 0) continue;
+        h->free = heap_caps_get_free_size(heap_classes[i]);
+        h->largest = heap_caps_get_largest_free_block(heap_classes[i]);
+        h->min_free = heap_caps_get_minimum_free_size(heap_classes[i]);
+        h->min_largest = (sample.samples && sample.min_largest[i] < h->largest) ? sample.min_largest[i] : h->largest;
+    }
+
+    stats->lvgl = sample.lvgl;
+    stats->samples = sample.samples;
+    memcpy(stats->subsys, subsys_bytes, sizeof(subsys_bytes));
+    stats->subsys[HOMEWIND_MEM_FONTS] = fonts_flash_bytes();
+    stats->subsys[HOMEWIND_MEM_TASKS] = task_stack_bytes();
+}
+
+const char* homewind_mem_subsys_name(homewind_mem_subsys_t subsys)
+{
+    if (subsys >= HOMEWIND_MEM_SUBSYS_COUNT) return "?";
+    return subsys_names[subsys];
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Memory Telemetry
+ * ============================================================================
+ * homewind_get_mem_stats() reads the ESP-IDF heaps live (free, largest block,
+ * minimum free since boot). LVGL pool data and the long-term watermarks come
+ * from a low-priority LVGL timer every HOMEWIND_MEM_SAMPLE_MS, which walks the
+ * heaps once; readers never take the LVGL lock. The per-subsystem breakdown
+ * is recorded once while the library starts up.
+ * ============================================================================ */
+
+#define HOMEWIND_MEM_SAMPLE_MS  10000   /* Watermark sampler period */
+
+/* --- Library Subsystems --- */
+typedef enum {
+    HOMEWIND_MEM_DRAW_BUFFERS = 0,  /* LVGL draw buffers (DMA-capable heap) */
+    HOMEWIND_MEM_SCREENS,           /* LVGL objects, styles, text of the library screens and overlays */
+    HOMEWIND_MEM_FONTS,             /* Built-in fonts: glyph bitmaps + descriptors (flash, not RAM) */
+    HOMEWIND_MEM_QR,                /* QR module buffers (static) */
+    HOMEWIND_MEM_HISTORY,           /* History rings + sparkline canvases (static) */
+    HOMEWIND_MEM_TASKS,             /* Stacks of the library tasks */
+    HOMEWIND_MEM_SUBSYS_COUNT
+} homewind_mem_subsys_t;
+
+/** One ESP-IDF heap class (all zero if the board has none, e.g. PSRAM) */
+typedef struct {
+    uint32_t total;
+    uint32_t free;
+    uint32_t largest;        /* Largest free block */
+    uint32_t min_free;       /* Least free since boot (IDF watermark) */
+    uint32_t min_largest;    /* Smallest largest block seen by the sampler */
+} homewind_heap_stats_t;
+
+/** LVGL pool (lv_mem_monitor), as of the last sample; all zero with LV_MEM_CUSTOM 1 */
+typedef struct {
+    uint32_t total;
+    uint32_t free;
+    uint32_t largest;
+    uint32_t max_used;       /* LVGL watermark */
+    uint8_t used_pct;
+    uint8_t frag_pct;
+    uint8_t max_frag_pct;    /* Worst fragmentation seen by the sampler */
+} homewind_lvgl_mem_stats_t;
+
+typedef struct {
+    homewind_heap_stats_t internal;     /* MALLOC_CAP_INTERNAL */
+    homewind_heap_stats_t psram;        /* MALLOC_CAP_SPIRAM */
+    homewind_heap_stats_t dma;          /* MALLOC_CAP_DMA */
+    homewind_lvgl_mem_stats_t lvgl;
+    uint32_t subsys[HOMEWIND_MEM_SUBSYS_COUNT];  /* Bytes per homewind_mem_subsys_t */
+    uint32_t samples;                   /* Sampler runs so far (0 = LVGL fields not filled yet) */
+} homewind_mem_stats_t;
+
+/**
+ * @brief Fill a memory report (any task, no LVGL lock)
+ */
+void homewind_get_mem_stats(homewind_mem_stats_t *stats);
+
+/**
+ * @brief Human-readable subsystem name (e.g. for Serial output)
+ */
+const char* homewind_mem_subsys_name(homewind_mem_subsys_t subsys);
+
+/* --- Internal (library) --- */
+void mem_stats_account(homewind_mem_subsys_t subsys, uint32_t bytes);  /* Fixed footprint, at init */
+void mem_stats_lvgl_begin(void);                                       /* Around LVGL object creation */
+void mem_stats_lvgl_end(homewind_mem_subsys_t subsys);
+void mem_stats_start(void);                                            /* Sampler timer (LVGL context) */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,226 @@
+// perf_stats.c
+#include "perf_stats.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#if HOMEWIND_PERF_STATS
+
+/* --- LVGL task counters ---
+ * Single writer. Every update bumps perf_seq to odd and back to even so a
+ * reader can tell whether its copy was torn. */
+typedef struct {
+    int64_t window_start_us;
+    uint32_t frames;
+    uint32_t flushes;
+    uint64_t flush_bytes;
+    uint64_t flush_us;
+    uint32_t render_count;
+    uint64_t render_us;
+    uint32_t render_max_us;
+    uint32_t render_hist[HOMEWIND_PERF_HIST_BUCKETS];
+    uint64_t busy_us;
+    uint32_t periods;
+    uint64_t period_us;
+    uint32_t period_max_us;
+    uint32_t touch_polls;
+    uint64_t residency_us[HOMEWIND_PERF_POWER_STATES];
+    uint8_t power_state;
+    int64_t power_since_us;
+} perf_counters_t;
+
+static perf_counters_t perf;
+static _Atomic uint32_t perf_seq = 0;
+static int64_t last_pass_start_us = 0;  /* LVGL task only */
+static bool frame_drawn = false;        /* flush_cb ran during the current pass */
+
+/* --- Other contexts --- */
+static volatile int64_t flush_start_us = 0;     /* Written before the DMA starts, read in its ISR */
+static _Atomic uint32_t flush_us_pending = 0;   /* ISR adds, LVGL task folds into perf.flush_us */
+static _Atomic uint32_t i2c_errors = 0;
+static _Atomic bool reset_req = false;
+
+static inline void perf_write_begin(void)
+{
+    atomic_fetch_add_explicit(&perf_seq, 1, memory_order_acq_rel);   /* -> odd */
+}
+
+static inline void perf_write_end(void)
+{
+    atomic_fetch_add_explicit(&perf_seq, 1, memory_order_release);   /* -> even */
+}
+
+static void perf_reset(int64_t now_us)
+{
+    uint8_t state = perf.power_state;
+    perf_write_begin();
+    memset(&perf, 0, sizeof(perf));
+    perf.window_start_us = now_us;
+    perf.power_state = state;
+    perf.power_since_us = now_us;
+    perf_write_end();
+    atomic_store_explicit(&i2c_errors, 0, memory_order_relaxed);
+}
+
+/* ============================================================================
+ * Hot-Path Hooks
+ * ============================================================================ */
+
+void perf_stats_lvgl_pass(int64_t start_us, uint32_t busy_us)
+{
+    if (perf.window_start_us == 0 || atomic_exchange_explicit(&reset_req, false, memory_order_relaxed)) {
+        perf_reset(start_us);
+    }
+    uint32_t flush_us = atomic_exchange_explicit(&flush_us_pending, 0, memory_order_relaxed);
+
+    perf_write_begin();
+    perf.busy_us += busy_us;
+    perf.flush_us += flush_us;
+    if (last_pass_start_us) {
+        uint32_t period = (uint32_t)(start_us - last_pass_start_us);
+        perf.period_us += period;
+        perf.periods++;
+        if (period > perf.period_max_us) perf.period_max_us = period;
+    }
+    if (frame_drawn) {
+        uint32_t bucket = busy_us / 1000;
+        if (bucket >= HOMEWIND_PERF_HIST_BUCKETS) bucket = HOMEWIND_PERF_HIST_BUCKETS - 1;
+        perf.render_hist[bucket]++;
+        perf.render_count++;
+        perf.render_us += busy_us;
+        if (busy_us > perf.render_max_us) perf.render_max_us = busy_us;
+    }
+    perf_write_end();
+
+    frame_drawn = false;
+    last_pass_start_us = start_us;
+}
+
+void perf_stats_lvgl_resumed(void)
+{
+    /* The suspend is no handler period (and would wrap the uint32 after ~71 min) */
+    last_pass_start_us = 0;
+}
+
+void perf_stats_flush_begin(uint32_t bytes, bool last)
+{
+    perf_write_begin();
+    perf.flushes++;
+    perf.flush_bytes += bytes;
+    if (last) perf.frames++;
+    perf_write_end();
+    frame_drawn = true;
+    flush_start_us = esp_timer_get_time();
+}
+
+void IRAM_ATTR perf_stats_flush_done(void)
+{
+    int64_t start = flush_start_us;
+    if (start) {
+        atomic_fetch_add_explicit(&flush_us_pending, (uint32_t)(esp_timer_get_time() - start), memory_order_relaxed);
+    }
+}
+
+void perf_stats_touch_poll(void)
+{
+    perf_write_begin();
+    perf.touch_polls++;
+    perf_write_end();
+}
+
+void perf_stats_i2c_error(void)
+{
+    atomic_fetch_add_explicit(&i2c_errors, 1, memory_order_relaxed);
+}
+
+void perf_stats_power_state(uint8_t state)
+{
+    int64_t now = esp_timer_get_time();
+    perf_write_begin();
+    if (perf.power_since_us && perf.power_state < HOMEWIND_PERF_POWER_STATES) {
+        perf.residency_us[perf.power_state] += now - perf.power_since_us;
+    }
+    perf.power_state = state;
+    perf.power_since_us = now;
+    perf_write_end();
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool homewind_get_perf_stats(homewind_perf_stats_t *stats)
+{
+    if (!stats) return false;
+    memset(stats, 0, sizeof(*stats));
+
+    /* A few attempts only: the writer may be preempted by this task on the
+     * same core, so spinning could dead-lock. Never hand out a torn copy. */
+    perf_counters_t c;
+    bool consistent = false;
+    for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+        uint32_t s1 = atomic_load_explicit(&perf_seq, memory_order_acquire);
+        memcpy(&c, &perf, sizeof(c));
+        atomic_thread_fence(memory_order_acquire);
+        consistent = !(s1 & 1u) && atomic_load_explicit(&perf_seq, memory_order_relaxed) == s1;
+    }
+    if (!consistent) return false;
+    if (c.window_start_us == 0) return true;  /* LVGL task not running yet */
+
+    int64_t now = esp_timer_get_time();
+    uint64_t window_us = (uint64_t)(now - c.window_start_us);
+    stats->window_ms = (uint32_t)(window_us / 1000);
+
+    stats->frames = c.frames;
+    stats->fps = window_us ? (float)c.frames * 1000000.0f / (float)window_us : 0.0f;
+    if (c.render_count) {
+        stats->render_avg_us = (uint32_t)(c.render_us / c.render_count);
+        stats->render_max_us = c.render_max_us;
+        uint32_t target = c.render_count - c.render_count / 100;  /* 99th percentile rank */
+        uint32_t seen = 0;
+        for (uint32_t i = 0; i < HOMEWIND_PERF_HIST_BUCKETS; i++) {
+            seen += c.render_hist[i];
+            if (seen >= target) {
+                stats->render_p99_us = (i + 1) * 1000;
+                break;
+            }
+        }
+        if (stats->render_p99_us > c.render_max_us) stats->render_p99_us = c.render_max_us;
+    }
+
+    stats->flushes = c.flushes;
+    stats->flush_bytes = c.flush_bytes;
+    stats->flush_avg_us = c.flushes ? (uint32_t)(c.flush_us / c.flushes) : 0;
+    stats->lvgl_cpu_pct = window_us ? (uint8_t)(c.busy_us * 100 / window_us) : 0;
+    stats->handler_period_avg_us = c.periods ? (uint32_t)(c.period_us / c.periods) : 0;
+    stats->handler_period_max_us = c.period_max_us;
+    stats->touch_polls = c.touch_polls;
+    stats->i2c_errors = atomic_load_explicit(&i2c_errors, memory_order_relaxed);
+
+    for (int i = 0; i < HOMEWIND_PERF_POWER_STATES; i++) {
+        uint64_t us = c.residency_us[i];
+        if (i == c.power_state && c.power_since_us) us += (uint64_t)(now - c.power_since_us);
+        stats->power_residency_ms[i] = (uint32_t)(us / 1000);
+    }
+    return true;
+}
+
+void homewind_reset_perf_stats(void)
+{
+    atomic_store_explicit(&reset_req, true, memory_order_relaxed);
+}
+
+#else /* !HOMEWIND_PERF_STATS */
+
+bool homewind_get_perf_stats(homewind_perf_stats_t *stats)
+{
+    if (stats) memset(stats, 0, sizeof(*stats));
+    return false;
+}
+
+void homewind_reset_perf_stats(void)
+{
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Runtime Performance Counters (HOMEWIND_PERF_STATS)
+ * ============================================================================
+ * Bumped in paths the library runs anyway: the LVGL port task (pass timing,
+ * CPU share), the flush callback and its DMA-done ISR, the touch read, the
+ * shared I2C helpers and the powersave inactivity timer. No locks: counters
+ * owned by the LVGL task sit behind a sequence count, the ISR and the I2C
+ * helpers use atomic adds. With HOMEWIND_PERF_STATS 0 every hook is an
+ * empty inline function and homewind_get_perf_stats() returns false.
+ * ============================================================================ */
+
+#define HOMEWIND_PERF_HIST_BUCKETS  64  /* Render-time histogram, 1 ms per bucket (last = overflow) */
+#define HOMEWIND_PERF_POWER_STATES  4   /* ui_power_state_t values */
+
+typedef struct {
+    uint32_t window_ms;                 /* Time covered (since boot or homewind_reset_perf_stats()) */
+    uint32_t frames;                    /* Completed display refreshes */
+    float fps;
+    uint32_t render_avg_us;             /* LVGL passes that drew something (frame hook + lv_timer_handler) */
+    uint32_t render_p99_us;             /* 1 ms resolution */
+    uint32_t render_max_us;
+    uint32_t flushes;                   /* flush_cb calls (several per frame with partial buffers) */
+    uint32_t flush_avg_us;              /* flush_cb to DMA done */
+    uint64_t flush_bytes;
+    uint8_t lvgl_cpu_pct;               /* LVGL task busy share of the window */
+    uint32_t handler_period_avg_us;     /* Between two lv_timer_handler() passes */
+    uint32_t handler_period_max_us;
+    uint32_t touch_polls;               /* FT3168 reads (after the poll rate limit) */
+    uint32_t i2c_errors;                /* Failed I2C transfers, touch + IMU */
+    uint32_t power_residency_ms[HOMEWIND_PERF_POWER_STATES];  /* Indexed by ui_power_state_t */
+} homewind_perf_stats_t;
+
+/**
+ * @brief Read the counters (any task)
+ * @return false if the library was built with HOMEWIND_PERF_STATS 0, or if
+ *         the LVGL task kept updating them during the read (stats zeroed; retry)
+ */
+bool homewind_get_perf_stats(homewind_perf_stats_t *stats);
+
+/** @brief Start a new window; applied by the LVGL task on its next pass */
+void homewind_reset_perf_stats(void);
+
+/* --- Internal (library hot paths) --- */
+#if HOMEWIND_PERF_STATS
+void perf_stats_lvgl_pass(int64_t start_us, uint32_t busy_us);  /* LVGL task, after each pass */
+void perf_stats_lvgl_resumed(void);                             /* LVGL task, back from suspend */
+void perf_stats_flush_begin(uint32_t bytes, bool last);         /* flush_cb, panel ready */
+void perf_stats_flush_done(void);                               /* Flush DMA done (ISR) */
+void perf_stats_touch_poll(void);                               /* LVGL task */
+void perf_stats_i2c_error(void);                                /* Any task */
+void perf_stats_power_state(uint8_t state);                     /* LVGL task */
+#else
+static inline void perf_stats_lvgl_pass(int64_t start_us, uint32_t busy_us) { (void)start_us; (void)busy_us; }
+static inline void perf_stats_lvgl_resumed(void) {}
+static inline void perf_stats_flush_begin(uint32_t bytes, bool last) { (void)bytes; (void)last; }
+static inline void perf_stats_flush_done(void) {}
+static inline void perf_stats_touch_poll(void) {}
+static inline void perf_stats_i2c_error(void) {}
+static inline void perf_stats_power_state(uint8_t state) { (void)state; }
+#endif
+
+#ifdef __cplusplus
+}
+#endif
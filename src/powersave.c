@@ -6,6 +6,9 @@
 #include "lvgl.h"
 #include "ui_colors.h"
 #include "ui_style_helpers.h"
+#include "mem_stats.h"
+#include "perf_stats.h"
+#include "event_trace.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -21,6 +24,10 @@ LV_FONT_DECLARE(lv_font_inter_bold_24);
 #define BRIGHTNESS_SOFT_MIN 80      // Soft powersave minimum brightness (~4%)
 #define BRIGHTNESS_SOFT_MAX 120      // Soft powersave maximum brightness (~20%)
 #define BREATHING_ANIM_TIME 6000    // 6 second cycle (more natural breathing rate)
+#define PANEL_OFF_TIMEOUT_MS (10UL * 60 * 1000)  // SOFT_POWERSAVE -> PANEL_OFF (0 = never)
+#define ANIM_FPS_ACTIVE          0   // 0 = LVGL_ANIM_FPS_MAX
+#define ANIM_FPS_DIMMED         30
+#define ANIM_FPS_SOFT_POWERSAVE 20   // Breathing only steps the backlight; 20 steps/s look smooth
 
 /* --- Breathing Curve Configuration --- */
 static breathing_ease_type_t inhale_ease = BREATHING_EASE_QUADRATIC_IN;
@@ -40,6 +47,12 @@ static ui_power_state_t current_power_state = UI_POWER_STATE_ACTIVE;
 static uint32_t last_activity_time = 0;
 static lv_timer_t *inactivity_timer = NULL;
 static bool powersave_locked = true;  /* Locked at init (Boot screen active) */
+static uint32_t soft_powersave_since = 0;
+static volatile uint32_t panel_off_timeout_ms = PANEL_OFF_TIMEOUT_MS;
+static volatile bool motion_wake_enabled = true;
+static volatile bool motion_wake_pending = false;  /* Set by the IMU task */
+static volatile bool face_down_off_enabled = true;
+static volatile bool face_down_pending = false;    /* Set by the IMU task */
 
 /* --- Screen Objects --- */
 static lv_obj_t *scr_powersave = NULL;
@@ -52,14 +65,10 @@ static lv_obj_t *powersave_fan_icon = NULL;
 static lv_obj_t *powersave_fan_label = NULL;
 static lv_anim_t brightness_anim;
 
-/* --- Cached formatted strings (avoid repeated snprintf) --- */
+/* --- Formatted label strings --- */
 static char powersave_hr_str[8] = "--";
-static uint16_t powersave_hr_cached = 0xFFFF;
 static char powersave_csc_str[8] = "--";
-static uint16_t powersave_csc_cached = 0xFFFF;
 static char powersave_fan_str[8] = "--";
-static uint8_t powersave_fan_active_cached = 0xFF;
-static uint8_t powersave_fan_total_cached = 0xFF;
 
 /* --- Get Main Screen (extern from homewind_ui.c) --- */
 extern lv_obj_t *scr_main;
@@ -276,10 +285,6 @@ static void stop_breathing_animation(void)
 /* --- Powersave Screen Creation --- */
 static void create_powersave_screen(void)
 {
-    lv_disp_t *disp = lv_disp_get_default();
-    lv_coord_t w = lv_disp_get_hor_res(disp);
-    lv_coord_t h = lv_disp_get_ver_res(disp);
-
     /* Create powersave screen with pure black background */
     scr_powersave = lv_obj_create(NULL);
     lv_obj_clear_flag(scr_powersave, LV_OBJ_FLAG_SCROLLABLE);
@@ -289,7 +294,7 @@ static void create_powersave_screen(void)
     /* Animated container for breathing effect */
     powersave_container = lv_obj_create(scr_powersave);
     apply_transparent_container_style(powersave_container);
-    lv_obj_set_size(powersave_container, w, h);
+    lv_obj_set_size(powersave_container, LV_PCT(100), LV_PCT(100));  /* Follows the screen on rotation */
     lv_obj_align(powersave_container, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_flex_flow(powersave_container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(powersave_container, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
@@ -350,6 +355,11 @@ static void deferred_soft_powersave_cb(lv_timer_t *timer)
 void powersave_lock(void)
 {
     powersave_locked = true;
+    /* Panel off: LVGL is suspended, let the resume path restore everything */
+    if (current_power_state == UI_POWER_STATE_PANEL_OFF) {
+        lcd_lvgl_wake();
+        return;
+    }
     /* State-Cleanup: end any active powersave state so AP screen is readable */
     if (current_power_state == UI_POWER_STATE_SOFT_POWERSAVE) {
         stop_breathing_animation();
@@ -365,10 +375,51 @@ void powersave_unlock(void)
     powersave_locked = false;
 }
 
+/* --- Animation frame-rate cap per power state --- */
+static void update_anim_fps(void)
+{
+    switch (current_power_state) {
+        case UI_POWER_STATE_DIMMED:         lcd_lvgl_set_anim_fps(ANIM_FPS_DIMMED); break;
+        case UI_POWER_STATE_SOFT_POWERSAVE: lcd_lvgl_set_anim_fps(ANIM_FPS_SOFT_POWERSAVE); break;
+        default:                            lcd_lvgl_set_anim_fps(ANIM_FPS_ACTIVE); break;
+    }
+}
+
+/* --- Residency counters + trace mark on state changes --- */
+static void power_state_sync(void)
+{
+    static ui_power_state_t traced_state = UI_POWER_STATE_ACTIVE;
+    perf_stats_power_state(current_power_state);
+    if (current_power_state != traced_state) {
+        traced_state = current_power_state;
+        event_trace_instant(HOMEWIND_TRACE_POWER, traced_state);
+    }
+}
+
 /* --- Inactivity Timer Callback --- */
 static void inactivity_timer_cb(lv_timer_t *timer)
 {
     LV_UNUSED(timer);
+    /* Several paths switch current_power_state directly; sync the cap, the
+     * residency counters and the trace here */
+    update_anim_fps();
+    power_state_sync();
+
+    /* Device picked up / tilted (IMU any-motion after rest) counts as activity */
+    if (motion_wake_pending) {
+        motion_wake_pending = false;
+        on_user_activity();
+        return;
+    }
+
+    /* Screen laid toward the ground (IMU face-down): panel off without the dim/soft steps */
+    if (face_down_pending) {
+        face_down_pending = false;
+        if (!powersave_locked && current_power_state != UI_POWER_STATE_PANEL_OFF) {
+            set_state_panel_off();
+            return;
+        }
+    }
 
     /* Touch-Detection first (always active, also when locked) */
     lv_indev_t *act_indev = lv_indev_get_act();
@@ -399,8 +450,11 @@ static void inactivity_timer_cb(lv_timer_t *timer)
         powersave_transition_pending = true;
         lv_timer_t *t = lv_timer_create(deferred_soft_powersave_cb, 1, NULL);
         lv_timer_set_repeat_count(t, 1);
+    } else if (current_power_state == UI_POWER_STATE_SOFT_POWERSAVE && panel_off_timeout_ms &&
+               now - soft_powersave_since > panel_off_timeout_ms) {
+        set_state_panel_off();
     }
-    /* Once in SOFT_POWERSAVE, stay there until user activity */
+    /* Once in PANEL_OFF, stay there until touch or new sensor data */
 }
 
 /* --- State Transition Functions --- */
@@ -423,6 +477,8 @@ void set_state_dimmed(void)
 
     set_amoled_backlight(BRIGHTNESS_DIMMED);
     current_power_state = UI_POWER_STATE_DIMMED;
+    update_anim_fps();
+    power_state_sync();
 }
 
 void set_state_soft_powersave(void)
@@ -435,6 +491,9 @@ void set_state_soft_powersave(void)
 
     /* Set state first so any code during/after load sees SOFT_POWERSAVE */
     current_power_state = UI_POWER_STATE_SOFT_POWERSAVE;
+    soft_powersave_since = lv_tick_get();
+    update_anim_fps();
+    power_state_sync();
 
     /* Set initial soft powersave brightness (will be animated) */
     set_amoled_backlight(BRIGHTNESS_SOFT_MIN);
@@ -445,6 +504,68 @@ void set_state_soft_powersave(void)
     start_breathing_animation();
 }
 
+void set_state_panel_off(void)
+{
+    if (current_power_state == UI_POWER_STATE_SOFT_POWERSAVE) {
+        stop_breathing_animation();
+    }
+    set_amoled_backlight(0);
+    current_power_state = UI_POWER_STATE_PANEL_OFF;
+    power_state_sync();  /* No timer ticks while suspended */
+    /* Port task turns the panel off and blocks after this pass */
+    lcd_lvgl_suspend();
+}
+
+/* --- Back from PANEL_OFF (LVGL task, after panel sleep-out) --- */
+static void panel_resume_cb(bool by_touch)
+{
+    LV_UNUSED(by_touch);
+    motion_wake_pending = false;
+    face_down_pending = false;
+    if (powersave_locked) {
+        /* powersave_lock() while off: keep the caller's Boot/AP screen, don't load main */
+        set_amoled_backlight(BRIGHTNESS_FULL);
+        current_power_state = UI_POWER_STATE_ACTIVE;
+        update_anim_fps();
+        last_activity_time = lv_tick_get();
+        return;
+    }
+    /* Touch or new sensor data: same wake path as from SOFT_POWERSAVE */
+    current_power_state = UI_POWER_STATE_SOFT_POWERSAVE;
+    on_user_activity();
+}
+
+/* --- IMU motion (IMU task context) --- */
+static void imu_motion_cb(void)
+{
+    if (!motion_wake_enabled) return;
+    motion_wake_pending = true;
+    /* Resumes LVGL from PANEL_OFF; otherwise the inactivity timer picks it up */
+    lcd_lvgl_wake();
+}
+
+void powersave_set_motion_wake(bool enable)
+{
+    motion_wake_enabled = enable;
+}
+
+/* --- IMU face-down (IMU task context) --- */
+static void imu_face_down_cb(void)
+{
+    if (!face_down_off_enabled) return;
+    face_down_pending = true;
+}
+
+void powersave_set_face_down_off(bool enable)
+{
+    face_down_off_enabled = enable;
+}
+
+void powersave_set_panel_off_timeout(uint32_t timeout_ms)
+{
+    panel_off_timeout_ms = timeout_ms;
+}
+
 ui_power_state_t get_ui_power_state(void)
 {
     return current_power_state;
@@ -469,6 +590,7 @@ void on_user_activity(void)
 
         set_amoled_backlight(BRIGHTNESS_FULL);
         current_power_state = UI_POWER_STATE_ACTIVE;
+        update_anim_fps();
 
         /* FIX: Refresh main screen widgets after powersave wake.
          * During SOFT_POWERSAVE, main screen updates were skipped by
@@ -480,7 +602,9 @@ void on_user_activity(void)
     }
 }
 
-/* --- Cached values for dirty-checking (avoid redundant UI updates) --- */
+/* --- Last-rendered snapshot of the powersave screen ---
+ * Only updated while the screen is shown; on entering SOFT_POWERSAVE the
+ * current values are diffed against it, so only changed slots are redrawn. */
 static struct {
     hr_state_t hr_state;
     csc_state_t csc_state;
@@ -488,105 +612,89 @@ static struct {
     uint16_t csc_value;
     uint8_t fan_active_count;
     uint8_t fan_total_count;
-    bool initialized;
-} powersave_cache = { 0 };
+    bool valid;
+} powersave_shown = { 0 };
 
-/* --- Update Powersave Icons (optimized with dirty-checking) --- */
+/* --- Update Powersave Icons (diffed against powersave_shown) --- */
 void update_powersave_icons(hr_state_t hr_state, csc_state_t csc_state,
                             uint16_t hr_value, uint16_t csc_value, uint8_t fan_active_count, uint8_t fan_total_count)
 {
     if (!scr_powersave) return;
-    
-    /* Skip update if powersave screen is not active (save CPU) */
-    if (current_power_state != UI_POWER_STATE_SOFT_POWERSAVE && powersave_cache.initialized) {
-        /* Just cache the values for when powersave becomes active */
-        powersave_cache.hr_state = hr_state;
-        powersave_cache.csc_state = csc_state;
-        powersave_cache.hr_value = hr_value;
-        powersave_cache.csc_value = csc_value;
-        powersave_cache.fan_active_count = fan_active_count;
-        powersave_cache.fan_total_count = fan_total_count;
-        return;
-    }
 
-    /* Update HR Sensor (only if changed) */
+    /* Not visible: nothing to render, the diff happens when it is shown */
+    if (current_power_state != UI_POWER_STATE_SOFT_POWERSAVE) return;
+
+    bool shown = powersave_shown.valid;
+
+    /* HR slot: icon follows connected/disconnected, label follows the value */
     if (powersave_hr_icon && powersave_hr_label) {
-        bool hr_changed = !powersave_cache.initialized || 
-                          hr_state != powersave_cache.hr_state || 
-                          hr_value != powersave_cache.hr_value;
-        if (hr_changed) {
-            if (hr_state == HR_STATE_ACTIVE) {
-                lv_label_set_text(powersave_hr_icon, "1");  // Heart icon
-                lv_obj_set_style_text_color(powersave_hr_icon, lv_color_hex(COLOR_ACCENT), 0);
-                if (hr_value != powersave_hr_cached) {
-                    snprintf(powersave_hr_str, sizeof(powersave_hr_str), "%d", hr_value);
-                    powersave_hr_cached = hr_value;
-                }
-                lv_label_set_text(powersave_hr_label, powersave_hr_str);
-            } else {
-                lv_label_set_text(powersave_hr_icon, "4");  // Disconnected icon
-                lv_obj_set_style_text_color(powersave_hr_icon, lv_color_hex(COLOR_DISCONNECTED), 0);
-                lv_label_set_text(powersave_hr_label, "--");
-            }
+        bool was_active = shown && powersave_shown.hr_state == HR_STATE_ACTIVE;
+        bool is_active = (hr_state == HR_STATE_ACTIVE);
+        if (!shown || was_active != is_active) {
+            lv_label_set_text(powersave_hr_icon, is_active ? "1" : "4");  // Heart / disconnected icon
+            lv_obj_set_style_text_color(powersave_hr_icon,
+                                        lv_color_hex(is_active ? COLOR_ACCENT : COLOR_DISCONNECTED), 0);
+        }
+        if (is_active && (!was_active || hr_value != powersave_shown.hr_value)) {
+            snprintf(powersave_hr_str, sizeof(powersave_hr_str), "%d", hr_value);
+            lv_label_set_text(powersave_hr_label, powersave_hr_str);
+        } else if (!is_active && (!shown || was_active)) {
+            lv_label_set_text(powersave_hr_label, "--");
         }
     }
 
-    /* Update CSC Sensor (only if changed) */
+    /* CSC slot: same icon glyph, color and label follow the state/value */
     if (powersave_csc_icon && powersave_csc_label) {
-        bool csc_changed = !powersave_cache.initialized ||
-                           csc_state != powersave_cache.csc_state ||
-                           csc_value != powersave_cache.csc_value;
-        if (csc_changed) {
-            if (csc_state == CSC_STATE_ACTIVE) {
-                lv_label_set_text(powersave_csc_icon, "5");  // CSC icon
-                lv_obj_set_style_text_color(powersave_csc_icon, lv_color_hex(COLOR_CSC), 0);
-                if (csc_value != powersave_csc_cached) {
-                    snprintf(powersave_csc_str, sizeof(powersave_csc_str), "%d", csc_value);
-                    powersave_csc_cached = csc_value;
-                }
-                lv_label_set_text(powersave_csc_label, powersave_csc_str);
-            } else {
-                lv_label_set_text(powersave_csc_icon, "5");  // CSC icon (same, but gray)
-                lv_obj_set_style_text_color(powersave_csc_icon, lv_color_hex(COLOR_DISCONNECTED), 0);
-                lv_label_set_text(powersave_csc_label, "--");
-            }
+        bool was_active = shown && powersave_shown.csc_state == CSC_STATE_ACTIVE;
+        bool is_active = (csc_state == CSC_STATE_ACTIVE);
+        if (!shown) {
+            lv_label_set_text(powersave_csc_icon, "5");  // CSC icon
+        }
+        if (!shown || was_active != is_active) {
+            lv_obj_set_style_text_color(powersave_csc_icon,
+                                        lv_color_hex(is_active ? COLOR_CSC : COLOR_DISCONNECTED), 0);
+        }
+        if (is_active && (!was_active || csc_value != powersave_shown.csc_value)) {
+            snprintf(powersave_csc_str, sizeof(powersave_csc_str), "%d", csc_value);
+            lv_label_set_text(powersave_csc_label, powersave_csc_str);
+        } else if (!is_active && (!shown || was_active)) {
+            lv_label_set_text(powersave_csc_label, "--");
         }
     }
 
-    /* Update Fan Sensor (when in SOFT_POWERSAVE we always apply current counts so display is correct on enter)
+    /* Fan slot
      * A1: no fans configured -> "--"
      * A2: active/configured -> "1/2" */
     if (powersave_fan_icon && powersave_fan_label) {
-        if (fan_total_count == 0) {
-            lv_label_set_text(powersave_fan_icon, "6");
-            lv_obj_set_style_text_color(powersave_fan_icon, lv_color_hex(COLOR_DISCONNECTED), 0);
-            lv_label_set_text(powersave_fan_label, "--");
-            powersave_fan_active_cached = 0;
-            powersave_fan_total_cached = 0;
-        } else {
-            /* Always set icon color from current state so first enter into powersave shows correct active/gray */
-            if (fan_active_count > 0) {
-                lv_label_set_text(powersave_fan_icon, "6");
-                lv_obj_set_style_text_color(powersave_fan_icon, lv_color_hex(COLOR_SUCCESS_ICON), 0);
+        bool counts_changed = !shown ||
+                              fan_active_count != powersave_shown.fan_active_count ||
+                              fan_total_count != powersave_shown.fan_total_count;
+        if (!shown) {
+            lv_label_set_text(powersave_fan_icon, "6");  // Fan icon
+        }
+        if (counts_changed) {
+            bool was_on = shown && powersave_shown.fan_total_count > 0 && powersave_shown.fan_active_count > 0;
+            bool is_on = fan_total_count > 0 && fan_active_count > 0;
+            if (!shown || was_on != is_on) {
+                lv_obj_set_style_text_color(powersave_fan_icon,
+                                            lv_color_hex(is_on ? COLOR_SUCCESS_ICON : COLOR_DISCONNECTED), 0);
+            }
+            if (fan_total_count == 0) {
+                lv_label_set_text(powersave_fan_label, "--");
             } else {
-                lv_label_set_text(powersave_fan_icon, "6");
-                lv_obj_set_style_text_color(powersave_fan_icon, lv_color_hex(COLOR_DISCONNECTED), 0);
+                snprintf(powersave_fan_str, sizeof(powersave_fan_str), "%d/%d", fan_active_count, fan_total_count);
+                lv_label_set_text(powersave_fan_label, powersave_fan_str);
             }
-            snprintf(powersave_fan_str, sizeof(powersave_fan_str), "%d/%d", fan_active_count, fan_total_count);
-            powersave_fan_active_cached = fan_active_count;
-            powersave_fan_total_cached = fan_total_count;
-            lv_label_set_text(powersave_fan_label, powersave_fan_str);
         }
     }
-    
-    /* Update cache */
-    powersave_cache.hr_state = hr_state;
-    powersave_cache.csc_state = csc_state;
-    powersave_cache.hr_value = hr_value;
-    powersave_cache.csc_value = csc_value;
-    powersave_cache.fan_active_count = fan_active_count;
-    powersave_cache.fan_total_count = fan_total_count;
-    powersave_cache.initialized = true;
+
+    powersave_shown.hr_state = hr_state;
+    powersave_shown.csc_state = csc_state;
+    powersave_shown.hr_value = hr_value;
+    powersave_shown.csc_value = csc_value;
+    powersave_shown.fan_active_count = fan_active_count;
+    powersave_shown.fan_total_count = fan_total_count;
+    powersave_shown.valid = true;
 }
 
 /* --- Initialization --- */
@@ -596,7 +704,9 @@ void powersave_init(void)
     if (!scr_main) return;
 
     /* Create powersave screen */
+    mem_stats_lvgl_begin();
     create_powersave_screen();
+    mem_stats_lvgl_end(HOMEWIND_MEM_SCREENS);
 
     /* Touch on main screen: reset inactivity timer; in DIMMED, wake (brightness full) */
     lv_obj_add_event_cb(scr_main, main_screen_touch_cb, LV_EVENT_PRESSING, NULL);
@@ -606,6 +716,9 @@ void powersave_init(void)
 
     /* Create inactivity timer (check every 500ms) */
     inactivity_timer = lv_timer_create(inactivity_timer_cb, 500, NULL);
+    lcd_lvgl_set_resume_callback(panel_resume_cb);
+    lcd_set_imu_motion_callback(imu_motion_cb);
+    lcd_set_imu_face_down_callback(imu_face_down_cb);
     
     /* Ensure display starts at full brightness */
     set_amoled_backlight(BRIGHTNESS_FULL);
@@ -11,7 +11,8 @@ extern "C" {
 typedef enum {
     UI_POWER_STATE_ACTIVE = 0,
     UI_POWER_STATE_DIMMED,
-    UI_POWER_STATE_SOFT_POWERSAVE
+    UI_POWER_STATE_SOFT_POWERSAVE,
+    UI_POWER_STATE_PANEL_OFF        /* Display off + sleep-in, LVGL suspended */
 } ui_power_state_t;
 
 /* --- Breathing Animation Easing Types --- */
@@ -37,6 +38,22 @@ ui_power_state_t get_ui_power_state(void);
 void set_state_active(void);
 void set_state_dimmed(void);
 void set_state_soft_powersave(void);
+void set_state_panel_off(void);
+/**
+ * @brief Time in SOFT_POWERSAVE before the panel is switched off (default 10 min, 0 = never)
+ * Touch or new sensor data restores the display.
+ */
+void powersave_set_panel_off_timeout(uint32_t timeout_ms);
+/**
+ * @brief Wake the UI when the IMU reports motion after rest (default on)
+ * Needs the QMI8658 INT pin (EXAMPLE_PIN_NUM_IMU_INT in lcd_config.h).
+ */
+void powersave_set_motion_wake(bool enable);
+/**
+ * @brief Switch the panel off as soon as the IMU sees the screen facing the ground (default on)
+ * Ignored while powersave is locked. Lifting the device wakes it again with motion wake.
+ */
+void powersave_set_face_down_off(bool enable);
 void update_powersave_icons(hr_state_t hr_state, csc_state_t csc_state, 
                             uint16_t hr_value, uint16_t csc_value, uint8_t fan_active_count, uint8_t fan_total_count);
 
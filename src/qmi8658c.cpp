@@ -9,13 +9,13 @@
 
 static char *tag = "qmi8658c";
 
-//#define QMI8658_UINT_MG_DPS
 #define M_PI			(3.14159265358979323846f)
-#define ONE_G			(9.807f)
+#define ONE_G			(QMI8658_ONE_G)
 #define QFABS(x)		(((x)<0.0f)?(-1.0f*(x)):(x))
 
 
 static qmi8658_state g_imu;
+static qmi8658_trace_hook_t g_trace_hook = NULL;
 #if defined(QMI8658_USE_CALI)
 static qmi8658_cali g_cali;
 #endif
@@ -107,6 +107,48 @@ void qmi8658_axis_convert(float data_a[3], float data_g[3], int layout)
 	}
 }
 
+// -32768 has no positive counterpart in a short: saturate instead of wrapping back to -32768
+static short qmi8658_neg_raw(short v)
+{
+	return (v == -32768) ? 32767 : (short)-v;
+}
+
+// Same mapping as qmi8658_axis_convert() on raw counts (gyro may be NULL)
+void qmi8658_axis_convert_raw(short data_a[3], short data_g[3], int layout)
+{
+	short g_dummy[3] = {0, 0, 0};
+	short raw_a[2] = {data_a[0], data_a[1]};
+	short raw_g[2];
+
+	if(data_g == NULL)
+	{
+		data_g = g_dummy;
+	}
+	raw_g[0] = data_g[0];
+	raw_g[1] = data_g[1];
+
+	if(layout >=4 && layout <= 7)
+	{
+		data_a[2] = qmi8658_neg_raw(data_a[2]);
+		data_g[2] = qmi8658_neg_raw(data_g[2]);
+	}
+	data_a[0] = (layout%2) ? raw_a[1] : raw_a[0];
+	data_a[1] = (layout%2) ? raw_a[0] : raw_a[1];
+	data_g[0] = (layout%2) ? raw_g[1] : raw_g[0];
+	data_g[1] = (layout%2) ? raw_g[0] : raw_g[1];
+
+	if((layout==1)||(layout==2)||(layout==4)||(layout==7))
+	{
+		data_a[0] = qmi8658_neg_raw(data_a[0]);
+		data_g[0] = qmi8658_neg_raw(data_g[0]);
+	}
+	if((layout==2)||(layout==3)||(layout==6)||(layout==7))
+	{
+		data_a[1] = qmi8658_neg_raw(data_a[1]);
+		data_g[1] = qmi8658_neg_raw(data_g[1]);
+	}
+}
+
 #if defined(QMI8658_USE_CALI)
 void qmi8658_data_cali(unsigned char sensor, float data[3])
 {
@@ -523,21 +565,70 @@ void qmi8658_read_timestamp(unsigned int *tim_count)
 	}
 }
 
-void qmi8658_read_sensor_data(float acc[3], float gyro[3])
+// Raw counts straight from the output registers (chip axes, no conversion)
+void qmi8658_read_sensor_raw(short acc[3], short gyro[3])
 {
 	unsigned char	buf_reg[12];
-	short 			raw_acc_xyz[3];
-	short 			raw_gyro_xyz[3];
 
 	qmi8658_read_reg(Qmi8658Register_Ax_L, buf_reg, 12);
-	raw_acc_xyz[0] = (short)((unsigned short)(buf_reg[1]<<8) |( buf_reg[0]));
-	raw_acc_xyz[1] = (short)((unsigned short)(buf_reg[3]<<8) |( buf_reg[2]));
-	raw_acc_xyz[2] = (short)((unsigned short)(buf_reg[5]<<8) |( buf_reg[4]));
+	acc[0] = (short)((unsigned short)(buf_reg[1]<<8) |( buf_reg[0]));
+	acc[1] = (short)((unsigned short)(buf_reg[3]<<8) |( buf_reg[2]));
+	acc[2] = (short)((unsigned short)(buf_reg[5]<<8) |( buf_reg[4]));
+
+	gyro[0] = (short)((unsigned short)(buf_reg[7]<<8) |( buf_reg[6]));
+	gyro[1] = (short)((unsigned short)(buf_reg[9]<<8) |( buf_reg[8]));
+	gyro[2] = (short)((unsigned short)(buf_reg[11]<<8) |( buf_reg[10]));
+}
+
+// Accelerometer value (m/s2, or mg with QMI8658_UINT_MG_DPS) -> raw counts at the current range.
+// Convert thresholds once with this and compare raw samples in integer arithmetic.
+short qmi8658_acc_to_raw(float value)
+{
+	return qmi8658_acc_to_raw_lsb(value, g_imu.ssvt_a);
+}
+
+unsigned short qmi8658_get_acc_lsb(void)
+{
+	return g_imu.ssvt_a;
+}
+
+unsigned short qmi8658_get_gyro_lsb(void)
+{
+	return g_imu.ssvt_g;
+}
+
+unsigned short qmi8658_get_odr_dhz(void)
+{
+	unsigned char odr = (unsigned char)g_imu.cfg.accOdr;
+
+	switch(odr)
+	{
+		case Qmi8658AccOdr_LowPower_128Hz:
+			return 1280;
+		case Qmi8658AccOdr_LowPower_21Hz:
+			return 210;
+		case Qmi8658AccOdr_LowPower_11Hz:
+			return 110;
+		case Qmi8658AccOdr_LowPower_3Hz:
+			return 30;
+		default:
+			// 8000 Hz >> odr (8000 Hz itself does not fit)
+			return (odr == Qmi8658AccOdr_8000Hz) ? 65535 : (unsigned short)(80000u >> odr);
+	}
+}
 
-	raw_gyro_xyz[0] = (short)((unsigned short)(buf_reg[7]<<8) |( buf_reg[6]));
-	raw_gyro_xyz[1] = (short)((unsigned short)(buf_reg[9]<<8) |( buf_reg[8]));
-	raw_gyro_xyz[2] = (short)((unsigned short)(buf_reg[11]<<8) |( buf_reg[10]));
+unsigned char qmi8658_get_sensors(void)
+{
+	return g_imu.cfg.enSensors;
+}
+
+void qmi8658_set_trace_hook(qmi8658_trace_hook_t hook)
+{
+	g_trace_hook = hook;
+}
 
+static void qmi8658_raw_to_float(const short raw_acc_xyz[3], const short raw_gyro_xyz[3], float acc[3], float gyro[3])
+{
 #if defined(QMI8658_UINT_MG_DPS)
 	// mg
 	acc[0] = (float)(raw_acc_xyz[0]*1000.0f)/g_imu.ssvt_a;
@@ -563,6 +654,15 @@ void qmi8658_read_sensor_data(float acc[3], float gyro[3])
 #endif
 }
 
+void qmi8658_read_sensor_data(float acc[3], float gyro[3])
+{
+	short 			raw_acc_xyz[3];
+	short 			raw_gyro_xyz[3];
+
+	qmi8658_read_sensor_raw(raw_acc_xyz, raw_gyro_xyz);
+	qmi8658_raw_to_float(raw_acc_xyz, raw_gyro_xyz, acc, gyro);
+}
+
 void qmi8658_read_xyz(float acc[3], float gyro[3])
 {
 	unsigned char	status;
@@ -584,8 +684,16 @@ void qmi8658_read_xyz(float acc[3], float gyro[3])
 #endif
 	if(data_ready)
 	{
-		qmi8658_read_sensor_data(acc, gyro);
-		qmi8658_axis_convert(acc, gyro, 0);
+		short raw_acc_xyz[3];
+		short raw_gyro_xyz[3];
+
+		qmi8658_read_sensor_raw(raw_acc_xyz, raw_gyro_xyz);
+		qmi8658_axis_convert_raw(raw_acc_xyz, raw_gyro_xyz, 0);	// same mapping as qmi8658_axis_convert()
+		if(g_trace_hook)
+		{
+			g_trace_hook(raw_acc_xyz, (g_imu.cfg.enSensors & QMI8658_GYR_ENABLE) ? raw_gyro_xyz : NULL, 1);
+		}
+		qmi8658_raw_to_float(raw_acc_xyz, raw_gyro_xyz, acc, gyro);
 #if defined(QMI8658_USE_CALI)
 		qmi8658_data_cali(1, acc);
 		qmi8658_data_cali(2, gyro);
@@ -609,6 +717,26 @@ void qmi8658_read_xyz(float acc[3], float gyro[3])
 	}
 }
 
+// Integer variant of qmi8658_read_xyz(): axis-converted raw counts, 0 if no new sample
+// (no calibration offsets; those are float and only exist with QMI8658_USE_CALI)
+unsigned char qmi8658_read_xyz_raw(short acc[3], short gyro[3])
+{
+	unsigned char	status;
+
+	qmi8658_read_reg(Qmi8658Register_Status0, &status, 1);
+	if(!(status&0x03))
+	{
+		return 0;
+	}
+	qmi8658_read_sensor_raw(acc, gyro);
+	qmi8658_axis_convert_raw(acc, gyro, 0);
+	if(g_trace_hook)
+	{
+		g_trace_hook(acc, (g_imu.cfg.enSensors & QMI8658_GYR_ENABLE) ? gyro : NULL, 1);
+	}
+	return 1;
+}
+
 
 void qmi8658_enableSensors(unsigned char enableFlags)
 {
@@ -658,7 +786,16 @@ void qmi8658_on_demand_cali(void)
 void qmi8658_config_reg(unsigned char low_power)
 {
 	qmi8658_enableSensors(QMI8658_DISABLE_ALL);
-	if(low_power)
+	if(low_power == QMI8658_CFG_FUSION)
+	{
+		// Gyro at the lowest ODR; 512dps keeps handlebar knocks in range
+		g_imu.cfg.enSensors = QMI8658_ACCGYR_ENABLE;
+		g_imu.cfg.accRange = Qmi8658AccRange_8g;
+		g_imu.cfg.accOdr = Qmi8658AccOdr_31_25Hz;
+		g_imu.cfg.gyrRange = Qmi8658GyrRange_512dps;
+		g_imu.cfg.gyrOdr = Qmi8658GyrOdr_31_25Hz;
+	}
+	else if(low_power)
 	{
 		g_imu.cfg.enSensors = QMI8658_ACC_ENABLE;
 		g_imu.cfg.accRange = Qmi8658AccRange_8g;
@@ -806,6 +943,21 @@ void qmi8658_enable_amd(unsigned char enable, enum qmi8658_Interrupt int_map, un
 
 	}
 }
+
+// No-motion event on the same INT pin as any-motion (call after qmi8658_enable_amd)
+void qmi8658_enable_no_motion(unsigned char enable)
+{
+	unsigned char sensors = g_imu.cfg.enSensors;	// enableSensors() overwrites it
+
+	qmi8658_enableSensors(QMI8658_DISABLE_ALL);
+	if(enable)
+		g_imu.cfg.ctrl8_value |= QMI8658_CTRL8_NOMOTION_EN;
+	else
+		g_imu.cfg.ctrl8_value &= (~QMI8658_CTRL8_NOMOTION_EN);
+	qmi8658_write_reg(Qmi8658Register_Ctrl8, g_imu.cfg.ctrl8_value);
+	qmi8658_delay(1);
+	qmi8658_enableSensors(sensors);
+}
 #endif
 
 #if defined(QMI8658_USE_PEDOMETER)
@@ -870,6 +1022,7 @@ unsigned int qmi8658_read_pedometer(void)
 void qmi8658_config_fifo(unsigned char watermark,enum qmi8658_FifoSize size,enum qmi8658_FifoMode mode,enum qmi8658_Interrupt int_map)
 {
 	unsigned char ctrl1;
+	unsigned char sensors = g_imu.cfg.enSensors;	// enableSensors() overwrites it
 
 	qmi8658_enableSensors(QMI8658_DISABLE_ALL);
 	qmi8658_read_reg(Qmi8658Register_Ctrl1, &ctrl1, 1);
@@ -888,10 +1041,26 @@ void qmi8658_config_fifo(unsigned char watermark,enum qmi8658_FifoSize size,enum
 	qmi8658_write_reg(Qmi8658Register_FifoWmkTh, watermark);
 
 	qmi8658_send_ctl9cmd(qmi8658_Ctrl9_Cmd_Rst_Fifo);
-	qmi8658_enableSensors(QMI8658_ACCGYR_ENABLE);
+	qmi8658_enableSensors(sensors);
 }
 
-unsigned short qmi8658_read_fifo(unsigned char* data)
+// Route the FIFO watermark interrupt to INT1 or INT2 (INT2 unused = masked)
+void qmi8658_set_fifo_int(enum qmi8658_Interrupt int_map)
+{
+	unsigned char ctrl1;
+
+	qmi8658_read_reg(Qmi8658Register_Ctrl1, &ctrl1, 1);
+	if(int_map == qmi8658_Int1)
+		ctrl1 |= QMI8658_FIFO_MAP_INT1;
+	else
+		ctrl1 &= QMI8658_FIFO_MAP_INT2;
+	qmi8658_write_reg(Qmi8658Register_Ctrl1, ctrl1);
+}
+
+// Drain up to max_samples FIFO frames in burst reads; returns frames read.
+// I2C per batch: FifoCount read, Req_Fifo handshake (Ctrl9 write, status read, NOP write,
+// status read, plus 1 ms polls if the chip is slow), burst read(s), FifoCtrl write = 7.
+static unsigned short qmi8658_fifo_drain(unsigned char* data, unsigned short max_samples)
 {
 	unsigned char fifo_status[2] = {0,0};
 	unsigned char fifo_sensors = 1;
@@ -913,26 +1082,120 @@ unsigned short qmi8658_read_fifo(unsigned char* data)
 			fifo_sensors = 2;
 		}
 		fifo_level = fifo_bytes/(3*fifo_sensors);
+		if(fifo_level > max_samples)
+		{
+			fifo_level = max_samples;
+		}
 		fifo_bytes = fifo_level*(6*fifo_sensors);
 		//qmi8658_log("fifo-level : %d\n", fifo_level);
 		if(fifo_level > 0)
 		{	
 			qmi8658_send_ctl9cmd(qmi8658_Ctrl9_Cmd_Req_Fifo);
-#if 1
-			for(int i=0; i<fifo_level; i++)
+			// Burst read: FifoData auto-increments through the FIFO (was one transaction per frame)
+			for(unsigned short off = 0; off < fifo_bytes; off += QMI8658_I2C_MAX_BURST)
 			{
-				qmi8658_read_reg(Qmi8658Register_FifoData, &data[i*fifo_sensors*6], fifo_sensors*6);
+				unsigned short chunk = fifo_bytes - off;
+				if(chunk > QMI8658_I2C_MAX_BURST)
+				{
+					chunk = QMI8658_I2C_MAX_BURST;
+				}
+				qmi8658_read_reg(Qmi8658Register_FifoData, &data[off], chunk);
 			}
-#else
-			qmi8658_read_reg(Qmi8658Register_FifoData, data, fifo_bytes);
-#endif
 			qmi8658_write_reg(Qmi8658Register_FifoCtrl, g_imu.cfg.fifo_ctrl);
 		}
-		qmi8658_send_ctl9cmd(qmi8658_Ctrl9_Cmd_Rst_Fifo);
+		// No Rst_Fifo: reading pops the frames in stream mode (a reset cost another Ctrl9 handshake)
 	}
 
 	return fifo_level;
 }
+
+unsigned short qmi8658_read_fifo(unsigned char* data)
+{
+	return qmi8658_fifo_drain(data, 0xffff);
+}
+
+// Mean of the buffered frames, raw counts after axis conversion. Accel-only FIFO: 6-byte
+// frames, gyro is not written; accel + gyro: 12-byte frames (acc, gyro), gyro may be NULL.
+// The batch mean is a box low-pass over the FIFO period (pedalling vibration averages out).
+unsigned short qmi8658_read_fifo_raw_mean(short acc[3], short gyro[3])
+{
+	unsigned char data[QMI8658_FIFO_ACC_MAX_SAMPLES * 12];
+	int sum[6] = {0, 0, 0, 0, 0, 0};
+	unsigned char axes;
+
+	if(g_imu.cfg.enSensors == QMI8658_ACC_ENABLE)
+	{
+		axes = 3;
+	}
+	else if(g_imu.cfg.enSensors == QMI8658_ACCGYR_ENABLE)
+	{
+		axes = 6;
+	}
+	else
+	{
+		return 0;
+	}
+	unsigned short n = qmi8658_fifo_drain(data, QMI8658_FIFO_ACC_MAX_SAMPLES);
+	for(unsigned short i = 0; i < n; i++)
+	{
+		const unsigned char *f = &data[i * axes * 2];
+		for(unsigned char k = 0; k < axes; k++)
+		{
+			sum[k] += (short)((unsigned short)(f[2 * k + 1] << 8) | f[2 * k]);
+		}
+	}
+	if(n == 0)
+	{
+		return 0;
+	}
+	short mean[6];
+	for(unsigned char k = 0; k < axes; k++)
+	{
+		// Rounded division (sum may be negative)
+		mean[k] = (short)((sum[k] >= 0 ? sum[k] + n / 2 : sum[k] - n / 2) / n);
+	}
+	for(int i = 0; i < 3; i++)
+	{
+		acc[i] = mean[i];
+		if(gyro && axes == 6)
+		{
+			gyro[i] = mean[3 + i];
+		}
+	}
+	qmi8658_axis_convert_raw(acc, (gyro && axes == 6) ? gyro : NULL, 0);
+	if(g_trace_hook)
+	{
+		g_trace_hook(acc, (gyro && axes == 6) ? gyro : NULL, n);
+	}
+	return n;
+}
+
+// Accelerometer-only mean (accel-only FIFO)
+unsigned short qmi8658_read_fifo_acc_raw_mean(short acc[3])
+{
+	if(g_imu.cfg.enSensors != QMI8658_ACC_ENABLE)
+	{
+		return 0;
+	}
+	return qmi8658_read_fifo_raw_mean(acc, NULL);
+}
+
+// Float wrapper of qmi8658_read_fifo_acc_raw_mean(), in m/s^2
+unsigned short qmi8658_read_fifo_acc_mean(float acc[3])
+{
+	short raw[3];
+	unsigned short n = qmi8658_read_fifo_acc_raw_mean(raw);
+
+	for(int i = 0; n && i < 3; i++)
+	{
+#if defined(QMI8658_UINT_MG_DPS)
+		acc[i] = (float)(raw[i] * 1000.0f) / g_imu.ssvt_a;
+#else
+		acc[i] = (float)(raw[i] * ONE_G) / g_imu.ssvt_a;
+#endif
+	}
+	return n;
+}
 #endif
 
 #if defined(QMI8658_SOFT_SELFTEST)
@@ -999,7 +1262,9 @@ unsigned char qmi8658_init(void)
 #endif
 		qmi8658_config_reg(0);
 		qmi8658_enableSensors(g_imu.cfg.enSensors);
+#ifdef QMI8658_DEBUG
 		qmi8658_dump_reg();
+#endif
 #if defined(QMI8658_USE_CALI)
 		memset(&g_cali, 0, sizeof(g_cali));
 #endif
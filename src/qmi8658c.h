@@ -1,14 +1,17 @@
 #ifndef QMI8658C_H
 #define QMI8658C_H
+#include "lcd_config.h"
 #define QMI8658_USE_SPI
 //#define QMI8658_SYNC_SAMPLE_MODE
 //#define QMI8658_SOFT_SELFTEST
 //#define QMI8658_USE_CALI
 
-// DISABLED: FIFO feature was compiled but never used - saves ~2KB code space
-//#define QMI8658_USE_FIFO
-//#define QMI8658_USE_AMD
+#define QMI8658_USE_FIFO			// Rotation task drains accel batches from the FIFO
+#if EXAMPLE_PIN_NUM_IMU_INT >= 0
+#define QMI8658_USE_AMD			// Any/no-motion interrupt (IMU task sleeps while the device is still), needs the INT pin
+#endif
 //#define QMI8658_USE_PEDOMETER
+//#define QMI8658_UINT_MG_DPS		// Float API in mg / dps instead of m/s2 / rad/s
 
 #define QMI8658_SLAVE_ADDR_L			0x6a
 #define QMI8658_SLAVE_ADDR_H			0x6b
@@ -18,8 +21,15 @@
 #define QMI8658_GYR_ENABLE				(0x2)
 #define QMI8658_ACCGYR_ENABLE			(QMI8658_ACC_ENABLE | QMI8658_GYR_ENABLE)
 
+// qmi8658_config_reg() / qmi8658_enable_amd() modes
+#define QMI8658_CFG_NORMAL				0		// Accel + gyro, 250 Hz
+#define QMI8658_CFG_LOW_POWER			1		// Accel only, low-power 21 Hz
+#define QMI8658_CFG_FUSION				2		// Accel + gyro, 31.25 Hz (tilt fusion)
+
 #define QMI8658_STATUS1_CMD_DONE		(0x01)
 #define QMI8658_STATUS1_WAKEUP_EVENT	(0x04)
+#define QMI8658_STATUS1_ANY_MOTION		(0x20)
+#define QMI8658_STATUS1_NO_MOTION		(0x40)
 
 #define QMI8658_CTRL8_DATAVALID_EN		0x40		// bit6:1 int1, 0 int2
 #define QMI8658_CTRL8_PEDOMETER_EN		0x10
@@ -36,6 +46,11 @@
 #define QMI8658_FIFO_MAP_INT1			0x04	// ctrl1
 #define QMI8658_FIFO_MAP_INT2			~0x04	// ctrl1
 
+#define QMI8658_ONE_G					(9.807f)	// m/s2 per g
+
+#define QMI8658_I2C_MAX_BURST			252		// Bytes per FIFO read transaction (multiple of 6 and 12)
+#define QMI8658_FIFO_ACC_MAX_SAMPLES	32		// qmi8658_read_fifo_*_mean() batch limit (frames)
+
 /* Debug log: define QMI8658_DEBUG in build to get IMU init/cali messages on Serial. */
 #ifdef QMI8658_DEBUG
 #  define qmi8658_log	printf
@@ -359,18 +374,54 @@ extern float qmi8658_readTemp(void);
 extern void qmi8658_read_timestamp(unsigned int *tim_count);
 extern void qmi8658_read_xyz(float acc[3], float gyro[3]);
 extern void qmi8658_read_sensor_data(float acc[3], float gyro[3]);
+/* Integer path: raw counts (accel: ssvt_a LSB per g), thresholds converted once */
+extern void qmi8658_read_sensor_raw(short acc[3], short gyro[3]);
+extern unsigned char qmi8658_read_xyz_raw(short acc[3], short gyro[3]);
+extern void qmi8658_axis_convert_raw(short data_a[3], short data_g[3], int layout);
+extern short qmi8658_acc_to_raw(float value);
+/* qmi8658_acc_to_raw() for a given range (counts per g): rounded, saturated to int16.
+   Inline so code built without the driver (imu_rotation.c, extras/) converts the same way. */
+static inline short qmi8658_acc_to_raw_lsb(float value, unsigned short lsb_per_g)
+{
+#if defined(QMI8658_UINT_MG_DPS)
+	float raw = value * lsb_per_g / 1000.0f;
+#else
+	float raw = value * lsb_per_g / QMI8658_ONE_G;
+#endif
+	if(raw > 32767.0f)
+		return 32767;
+	if(raw < -32768.0f)
+		return -32768;
+	return (short)(raw < 0.0f ? raw - 0.5f : raw + 0.5f);
+}
+extern unsigned short qmi8658_get_acc_lsb(void);		// Counts per g
+extern unsigned short qmi8658_get_gyro_lsb(void);	// Counts per deg/s
+extern unsigned short qmi8658_get_odr_dhz(void);	// Accelerometer ODR in 0.1 Hz
+extern unsigned char qmi8658_get_sensors(void);		// QMI8658_ACC_ENABLE / QMI8658_GYR_ENABLE bits
+/* Debug hook: every qmi8658_read_xyz(), qmi8658_read_xyz_raw() and FIFO mean read passes its
+   axis-converted raw counts here (gyro NULL when not running). Runs in the reading task. */
+typedef void (*qmi8658_trace_hook_t)(const short acc[3], const short gyro[3], unsigned short samples);
+extern void qmi8658_set_trace_hook(qmi8658_trace_hook_t hook);
 #if defined(QMI8658_USE_PEDOMETER)
 extern unsigned int qmi8658_read_pedometer(void);
 #endif
 #if defined(QMI8658_USE_AMD)
 void qmi8658_config_amd(void);
 void qmi8658_enable_amd(unsigned char enable, enum qmi8658_Interrupt int_map, unsigned char low_power);
+void qmi8658_enable_no_motion(unsigned char enable);
 #endif
 #if defined(QMI8658_USE_FIFO)
 extern void qmi8658_config_fifo(unsigned char watermark,enum qmi8658_FifoSize size,enum qmi8658_FifoMode mode,enum qmi8658_Interrupt int_map);
 extern unsigned short qmi8658_read_fifo(unsigned char* data);
+extern unsigned short qmi8658_read_fifo_acc_mean(float acc[3]);
+extern unsigned short qmi8658_read_fifo_acc_raw_mean(short acc[3]);
+extern unsigned short qmi8658_read_fifo_raw_mean(short acc[3], short gyro[3]);
+extern void qmi8658_set_fifo_int(enum qmi8658_Interrupt int_map);
 #endif
 extern void qmi8658_send_ctl9cmd(enum qmi8658_Ctrl9Command cmd);
+#if defined(QMI8658_SOFT_SELFTEST)
+extern unsigned char qmi8658_do_selftest(void);
+#endif
 
 // REMOVED: qmi8658c_example() declaration - unused, IMU uses lcd_start_imu_rotation_task() instead
 
@@ -0,0 +1,142 @@
+// sensor_filter.c
+#include "sensor_filter.h"
+#include <stdatomic.h>
+
+/* --- Packed config word: bits 0-7 median, 8-15 EMA shift, 16-23 deadband --- */
+#define CFG_PACK(m, s, d)   ((uint32_t)(m) | ((uint32_t)(s) << 8) | ((uint32_t)(d) << 16))
+#define CFG_MEDIAN(w)       ((uint8_t)((w) & 0xFFu))
+#define CFG_EMA_SHIFT(w)    ((uint8_t)(((w) >> 8) & 0xFFu))
+#define CFG_DEADBAND(w)     ((uint8_t)(((w) >> 16) & 0xFFu))
+#define EMA_FRAC_BITS       8       /* EMA accumulator in Q8 */
+#define EMA_MAX_SHIFT       6
+
+#define HR_DEFAULT_CONFIG       CFG_PACK(3, 1, 1)
+#define CADENCE_DEFAULT_CONFIG  CFG_PACK(5, 2, 2)   /* Raw BLE cadence jitters by about +/-5 rpm */
+
+typedef struct {
+    /* Config (any task) */
+    _Atomic uint32_t config;
+    _Atomic bool reset_req;
+    /* Filter state (value-setter task only) */
+    uint32_t applied_config;
+    uint16_t window[HOMEWIND_FILTER_MAX_MEDIAN];
+    uint8_t window_len;
+    uint8_t window_pos;
+    int32_t ema_q8;
+    uint16_t shown;
+    bool primed;
+} sensor_filter_t;
+
+static sensor_filter_t filters[2] = {
+    [HOMEWIND_METRIC_HR]      = { .config = HR_DEFAULT_CONFIG },
+    [HOMEWIND_METRIC_CADENCE] = { .config = CADENCE_DEFAULT_CONFIG },
+};
+
+/* ============================================================================
+ * Stages
+ * ============================================================================ */
+
+static uint16_t median_push(sensor_filter_t *f, uint8_t n, uint16_t raw)
+{
+    f->window[f->window_pos] = raw;
+    f->window_pos = (uint8_t)((f->window_pos + 1) % n);
+    if (f->window_len < n) f->window_len++;
+
+    /* Insertion sort of at most 7 values */
+    uint16_t sorted[HOMEWIND_FILTER_MAX_MEDIAN];
+    for (uint8_t i = 0; i < f->window_len; i++) {
+        uint16_t v = f->window[i];
+        int8_t j = (int8_t)i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[f->window_len / 2];
+}
+
+static void filter_restart(sensor_filter_t *f, uint16_t raw)
+{
+    f->window_len = 0;
+    f->window_pos = 0;
+    f->ema_q8 = (int32_t)raw << EMA_FRAC_BITS;
+    f->shown = raw;
+    f->primed = true;
+}
+
+/* ============================================================================
+ * Internal API
+ * ============================================================================ */
+
+uint16_t sensor_filter_update(homewind_metric_t metric, uint16_t raw)
+{
+    if (metric > HOMEWIND_METRIC_CADENCE) return raw;
+    sensor_filter_t *f = &filters[metric];
+
+    uint32_t cfg = atomic_load_explicit(&f->config, memory_order_relaxed);
+    bool reset = atomic_exchange_explicit(&f->reset_req, false, memory_order_relaxed);
+    if (cfg != f->applied_config) {
+        f->applied_config = cfg;
+        reset = true;
+    }
+
+    /* 0 = no reading / not pedaling: show it at once and start over */
+    if (raw == 0 || reset || !f->primed) {
+        filter_restart(f, raw);
+        if (raw == 0) f->primed = false;
+        if (raw && CFG_MEDIAN(cfg) > 1) median_push(f, CFG_MEDIAN(cfg), raw);
+        return raw;
+    }
+
+    uint16_t v = (CFG_MEDIAN(cfg) > 1) ? median_push(f, CFG_MEDIAN(cfg), raw) : raw;
+
+    uint8_t shift = CFG_EMA_SHIFT(cfg);
+    if (shift) {
+        f->ema_q8 += (((int32_t)v << EMA_FRAC_BITS) - f->ema_q8) >> shift;
+        v = (uint16_t)((f->ema_q8 + (1 << (EMA_FRAC_BITS - 1))) >> EMA_FRAC_BITS);
+    }
+
+    /* Hysteresis: hold the shown value until the reading leaves the band */
+    int32_t delta = (int32_t)v - (int32_t)f->shown;
+    if (delta > CFG_DEADBAND(cfg) || delta < -(int32_t)CFG_DEADBAND(cfg)) {
+        f->shown = v;
+    }
+    return f->shown;
+}
+
+void sensor_filter_reset(homewind_metric_t metric)
+{
+    if (metric > HOMEWIND_METRIC_CADENCE) return;
+    atomic_store_explicit(&filters[metric].reset_req, true, memory_order_relaxed);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void homewind_set_filter(homewind_metric_t metric, const homewind_filter_config_t *config)
+{
+    if (metric > HOMEWIND_METRIC_CADENCE) return;
+    uint32_t cfg = (metric == HOMEWIND_METRIC_HR) ? HR_DEFAULT_CONFIG : CADENCE_DEFAULT_CONFIG;
+    if (config) {
+        uint8_t median = config->median_window;
+        if (median < 1) median = 1;
+        if (median > HOMEWIND_FILTER_MAX_MEDIAN) median = HOMEWIND_FILTER_MAX_MEDIAN;
+        if (!(median & 1u)) median++;  /* Median needs an odd window */
+        uint8_t shift = config->ema_shift > EMA_MAX_SHIFT ? EMA_MAX_SHIFT : config->ema_shift;
+        cfg = CFG_PACK(median, shift, config->deadband);
+    }
+    atomic_store_explicit(&filters[metric].config, cfg, memory_order_relaxed);
+}
+
+homewind_filter_config_t homewind_get_filter(homewind_metric_t metric)
+{
+    homewind_filter_config_t out = { 1, 0, 0 };
+    if (metric > HOMEWIND_METRIC_CADENCE) return out;
+    uint32_t cfg = atomic_load_explicit(&filters[metric].config, memory_order_relaxed);
+    out.median_window = CFG_MEDIAN(cfg);
+    out.ema_shift = CFG_EMA_SHIFT(cfg);
+    out.deadband = CFG_DEADBAND(cfg);
+    return out;
+}
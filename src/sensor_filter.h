@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Sensor Smoothing (HR / Cadence)
+ * ============================================================================
+ * Runs inside homewind_set_hr*() / homewind_set_csc*() before the value
+ * reaches the UI state, so the label only changes when the reading really
+ * moves. Stages, all integer: median-of-N -> EMA -> hysteresis deadband.
+ * Filter state belongs to the task that calls the value setters (one writer
+ * task per metric, like the sensor name); the config can be changed from
+ * any task.
+ * ============================================================================ */
+
+#define HOMEWIND_FILTER_MAX_MEDIAN  7   /* Largest median window (odd) */
+
+typedef enum {
+    HOMEWIND_METRIC_HR = 0,
+    HOMEWIND_METRIC_CADENCE
+} homewind_metric_t;
+
+typedef struct {
+    uint8_t median_window;  /* 1 = off, odd values up to HOMEWIND_FILTER_MAX_MEDIAN */
+    uint8_t ema_shift;      /* 0 = off, n: new = old + (x - old) / 2^n */
+    uint8_t deadband;       /* Shown value changes only if the filtered value moves more than this */
+} homewind_filter_config_t;
+
+/* Defaults: HR median 3 / EMA 1/2 / deadband 1, cadence median 5 / EMA 1/4 / deadband 2 */
+
+/**
+ * @brief Configure the smoothing of one metric (NULL = restore defaults)
+ * Safe from any task; the filter restarts with the next sample.
+ */
+void homewind_set_filter(homewind_metric_t metric, const homewind_filter_config_t *config);
+
+/**
+ * @brief Read the current smoothing config of one metric
+ */
+homewind_filter_config_t homewind_get_filter(homewind_metric_t metric);
+
+/* --- Internal (library, value setters) --- */
+uint16_t sensor_filter_update(homewind_metric_t metric, uint16_t raw);
+void sensor_filter_reset(homewind_metric_t metric);
+
+#ifdef __cplusplus
+}
+#endif
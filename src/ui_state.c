@@ -0,0 +1,388 @@
+// ui_state.c
+#include "ui_state.h"
+#include <stdatomic.h>
+#include <string.h>
+
+/* --- Packed scalar words ---
+ * hr/csc:  bits 0-15 value, bits 16-23 state
+ * fans:    4 bits per fan: bits 0-2 state, bit 3 is_on */
+#define PACK_VALUE_MASK     0x0000FFFFu
+#define PACK_STATE_SHIFT    16
+#define FAN_BITS            4
+#define FAN_STATE_MASK      0x7u
+#define FAN_ON_BIT          0x8u
+
+static _Atomic uint32_t hr_word = ((uint32_t)HR_NOT_CONFIGURATED << PACK_STATE_SHIFT);
+static _Atomic uint32_t csc_word = ((uint32_t)CSC_NOT_CONFIGURATED << PACK_STATE_SHIFT);
+static _Atomic uint32_t fan_word = 0;          /* All FAN_STATE_NOT_CONFIGURATED, off */
+static _Atomic uint32_t fan_anim_mask = 0;     /* Fans whose on/off change should animate */
+static _Atomic uint32_t fan_count_word = HOMEWIND_DEFAULT_FAN_COUNT;
+static _Atomic uint32_t dirty_mask = 0;
+
+/* --- Open batches, one slot per task ---
+ * owner is claimed with a CAS; everything else is only touched by the owner
+ * task, so another task's setters never land in (or wait for) this batch.
+ * Staged values live here, not in the shared words, until the outermost
+ * commit: the LVGL task can apply any field at any time (another task's
+ * setter, a held value coming due) without ever seeing half a batch. */
+typedef struct {
+    _Atomic(const void *) owner;               /* NULL: slot free */
+    uint32_t depth;                            /* Nesting of homewind_begin_update() */
+    uint32_t staged;                           /* Dirty bits held back until commit */
+    uint32_t hr_word;                          /* Staged values, valid for the staged bits only */
+    uint32_t csc_word;
+    uint32_t fan_word;
+    uint32_t fan_anim;
+    uint32_t fan_count;
+    char hr_name[UI_STATE_NAME_LEN];
+    char csc_name[UI_STATE_NAME_LEN];
+    char qr_url[UI_STATE_URL_LEN];
+} ui_batch_t;
+
+static ui_batch_t batches[UI_STATE_BATCH_SLOTS];
+
+/* --- Sequence-counted strings (odd seq = write in progress) --- */
+typedef struct {
+    _Atomic uint32_t seq;
+    char buf[UI_STATE_NAME_LEN];
+} ui_name_field_t;
+
+static ui_name_field_t hr_name_field = { 0, "" };
+static ui_name_field_t csc_name_field = { 0, "CSC Sensor" };
+static struct {
+    _Atomic uint32_t seq;
+    char buf[UI_STATE_URL_LEN];
+} qr_url_field = { 0, "https://martin-lihs.com" };
+
+static bool str_field_write(_Atomic uint32_t *seq, char *buf, size_t cap, const char *src)
+{
+    /* Only the owning writer modifies buf, so reading it here is safe */
+    if (strncmp(buf, src, cap - 1) == 0) return false;
+    atomic_fetch_add_explicit(seq, 1, memory_order_acq_rel);   /* -> odd */
+    strncpy(buf, src, cap - 1);
+    buf[cap - 1] = '\0';
+    atomic_fetch_add_explicit(seq, 1, memory_order_release);   /* -> even */
+    return true;
+}
+
+static bool str_field_read(_Atomic uint32_t *seq, const char *buf, char *out, size_t len)
+{
+    /* Single attempt: the writer may be preempted by the LVGL task on the
+     * same core, so spinning here could dead-lock. */
+    uint32_t s1 = atomic_load_explicit(seq, memory_order_acquire);
+    if (s1 & 1u) return false;
+    strncpy(out, buf, len - 1);
+    out[len - 1] = '\0';
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(seq, memory_order_relaxed) == s1;
+}
+
+/* CAS helper: replace bits under mask, return true if the word changed */
+static bool word_update(_Atomic uint32_t *word, uint32_t mask, uint32_t bits)
+{
+    uint32_t old = atomic_load_explicit(word, memory_order_relaxed);
+    uint32_t desired;
+    do {
+        desired = (old & ~mask) | (bits & mask);
+        if (desired == old) return false;
+    } while (!atomic_compare_exchange_weak_explicit(word, &old, desired,
+                                                    memory_order_release, memory_order_relaxed));
+    return true;
+}
+
+static ui_batch_t *batch_find(const void *task)
+{
+    for (int i = 0; i < UI_STATE_BATCH_SLOTS; i++) {
+        if (atomic_load_explicit(&batches[i].owner, memory_order_relaxed) == task) return &batches[i];
+    }
+    return NULL;
+}
+
+/* Packed-word write: into the shared word, or into the batch copy if the task has one
+ * open. A field not staged yet first loads its bits (field_mask) from the shared word, so
+ * the comparison and the bits this write leaves alone match an unbatched write. */
+static bool field_update(ui_batch_t *batch, uint32_t *staged_word, _Atomic uint32_t *word,
+                         uint32_t field, uint32_t field_mask, uint32_t mask, uint32_t bits)
+{
+    if (!batch) return word_update(word, mask, bits);
+    if (!(batch->staged & field)) {
+        uint32_t shared = atomic_load_explicit(word, memory_order_relaxed);
+        *staged_word = (*staged_word & ~field_mask) | (shared & field_mask);
+    }
+    uint32_t desired = (*staged_word & ~mask) | (bits & mask);
+    if (desired == *staged_word) return false;
+    *staged_word = desired;
+    return true;
+}
+
+/* String write: same split; the shared buffer is only read here (one writer task per field) */
+static bool str_update(ui_batch_t *batch, char *staged_buf, uint32_t field,
+                       _Atomic uint32_t *seq, char *buf, size_t cap, const char *src)
+{
+    if (!batch) return str_field_write(seq, buf, cap, src);
+    const char *current = (batch->staged & field) ? staged_buf : buf;
+    if (strncmp(current, src, cap - 1) == 0) return false;
+    strncpy(staged_buf, src, cap - 1);
+    staged_buf[cap - 1] = '\0';
+    return true;
+}
+
+/* ============================================================================
+ * Writer side
+ * ============================================================================ */
+
+uint32_t ui_state_set_hr_state(hr_state_t state, const void *task)
+{
+    ui_batch_t *b = batch_find(task);
+    return field_update(b, b ? &b->hr_word : NULL, &hr_word, UI_FIELD_HR_STATE,
+                        ~PACK_VALUE_MASK, ~PACK_VALUE_MASK, (uint32_t)state << PACK_STATE_SHIFT)
+        ? UI_FIELD_HR_STATE : 0;
+}
+
+uint32_t ui_state_set_hr_value(uint16_t value, const void *task)
+{
+    ui_batch_t *b = batch_find(task);
+    return field_update(b, b ? &b->hr_word : NULL, &hr_word, UI_FIELD_HR_VALUE,
+                        PACK_VALUE_MASK, PACK_VALUE_MASK, value)
+        ? UI_FIELD_HR_VALUE : 0;
+}
+
+uint32_t ui_state_set_hr_name(const char *name, const void *task)
+{
+    if (!name) return 0;
+    ui_batch_t *b = batch_find(task);
+    return str_update(b, b ? b->hr_name : NULL, UI_FIELD_HR_NAME,
+                      &hr_name_field.seq, hr_name_field.buf, sizeof(hr_name_field.buf), name)
+        ? UI_FIELD_HR_NAME : 0;
+}
+
+uint32_t ui_state_set_csc_state(csc_state_t state, const void *task)
+{
+    ui_batch_t *b = batch_find(task);
+    return field_update(b, b ? &b->csc_word : NULL, &csc_word, UI_FIELD_CSC_STATE,
+                        ~PACK_VALUE_MASK, ~PACK_VALUE_MASK, (uint32_t)state << PACK_STATE_SHIFT)
+        ? UI_FIELD_CSC_STATE : 0;
+}
+
+uint32_t ui_state_set_csc_cadence(uint16_t cadence, const void *task)
+{
+    ui_batch_t *b = batch_find(task);
+    return field_update(b, b ? &b->csc_word : NULL, &csc_word, UI_FIELD_CSC_CADENCE,
+                        PACK_VALUE_MASK, PACK_VALUE_MASK, cadence)
+        ? UI_FIELD_CSC_CADENCE : 0;
+}
+
+uint32_t ui_state_set_csc_name(const char *name, const void *task)
+{
+    if (!name) return 0;
+    ui_batch_t *b = batch_find(task);
+    return str_update(b, b ? b->csc_name : NULL, UI_FIELD_CSC_NAME,
+                      &csc_name_field.seq, csc_name_field.buf, sizeof(csc_name_field.buf), name)
+        ? UI_FIELD_CSC_NAME : 0;
+}
+
+uint32_t ui_state_set_fan(uint8_t index, fan_state_t state, bool is_on, const void *task)
+{
+    if (index >= UI_STATE_MAX_FANS) return 0;
+    ui_batch_t *b = batch_find(task);
+    uint32_t shift = index * FAN_BITS;
+    uint32_t fan_mask = (FAN_STATE_MASK | FAN_ON_BIT) << shift;
+    uint32_t bits = ((uint32_t)state & FAN_STATE_MASK) | (is_on ? FAN_ON_BIT : 0);
+    return field_update(b, b ? &b->fan_word : NULL, &fan_word, UI_FIELD_FAN(index),
+                        fan_mask, fan_mask, bits << shift)
+        ? UI_FIELD_FAN(index) : 0;
+}
+
+uint32_t ui_state_set_fan_state(uint8_t index, fan_state_t state, const void *task)
+{
+    if (index >= UI_STATE_MAX_FANS) return 0;
+    /* Not configured / inactive fans are always off */
+    if (state == FAN_STATE_NOT_CONFIGURATED || state == FAN_STATE_INACTIVE) {
+        return ui_state_set_fan(index, state, false, task);
+    }
+    ui_batch_t *b = batch_find(task);
+    uint32_t shift = index * FAN_BITS;
+    return field_update(b, b ? &b->fan_word : NULL, &fan_word, UI_FIELD_FAN(index),
+                        (FAN_STATE_MASK | FAN_ON_BIT) << shift,
+                        FAN_STATE_MASK << shift, ((uint32_t)state & FAN_STATE_MASK) << shift)
+        ? UI_FIELD_FAN(index) : 0;
+}
+
+uint32_t ui_state_set_fan_on(uint8_t index, bool is_on, bool animate, const void *task)
+{
+    if (index >= UI_STATE_MAX_FANS) return 0;
+    ui_batch_t *b = batch_find(task);
+    uint32_t shift = index * FAN_BITS;
+    if (!field_update(b, b ? &b->fan_word : NULL, &fan_word, UI_FIELD_FAN(index),
+                      (FAN_STATE_MASK | FAN_ON_BIT) << shift,
+                      FAN_ON_BIT << shift, (is_on ? FAN_ON_BIT : 0) << shift)) return 0;
+    if (animate) {
+        if (b) b->fan_anim |= 1u << index;
+        else atomic_fetch_or_explicit(&fan_anim_mask, 1u << index, memory_order_relaxed);
+    }
+    return UI_FIELD_FAN(index);
+}
+
+uint32_t ui_state_set_qr_url(const char *url, const void *task)
+{
+    if (!url) return 0;
+    ui_batch_t *b = batch_find(task);
+    return str_update(b, b ? b->qr_url : NULL, UI_FIELD_QR_URL,
+                      &qr_url_field.seq, qr_url_field.buf, sizeof(qr_url_field.buf), url)
+        ? UI_FIELD_QR_URL : 0;
+}
+
+static bool publish_now(uint32_t fields)
+{
+    if (!fields) return false;
+    return atomic_fetch_or_explicit(&dirty_mask, fields, memory_order_release) == 0;
+}
+
+uint32_t ui_state_set_fan_count(uint8_t count, const void *task)
+{
+    if (count > UI_STATE_MAX_FANS) count = UI_STATE_MAX_FANS;
+    ui_batch_t *b = batch_find(task);
+    if (b) {
+        uint32_t current = (b->staged & UI_FIELD_FAN_COUNT)
+            ? b->fan_count : atomic_load_explicit(&fan_count_word, memory_order_relaxed);
+        b->fan_count = count;
+        return current != count ? UI_FIELD_FAN_COUNT : 0;
+    }
+    return atomic_exchange_explicit(&fan_count_word, count, memory_order_release) != count
+        ? UI_FIELD_FAN_COUNT : 0;
+}
+
+bool ui_state_publish(uint32_t fields, const void *task)
+{
+    if (!fields) return false;
+    ui_batch_t *batch = batch_find(task);
+    if (batch) {
+        batch->staged |= fields;
+        return false;
+    }
+    return publish_now(fields);
+}
+
+void ui_state_begin(const void *task)
+{
+    ui_batch_t *batch = batch_find(task);
+    for (int i = 0; !batch && i < UI_STATE_BATCH_SLOTS; i++) {
+        const void *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&batches[i].owner, &expected, task,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            batch = &batches[i];
+        }
+    }
+    if (batch) batch->depth++;         /* No free slot: this task's setters apply unbatched */
+}
+
+bool ui_state_commit(const void *task)
+{
+    ui_batch_t *batch = batch_find(task);
+    if (!batch) return false;          /* Unbalanced commit, or begin found no slot */
+    if (--batch->depth != 0) return false;  /* Still nested */
+
+    /* Values first, then the dirty bits (release): the reader never sees a bit
+     * without its value. Only staged fields are copied; the rest of each shared
+     * word may have moved on under other tasks' setters. */
+    uint32_t staged = batch->staged;
+    uint32_t hr_mask = ((staged & UI_FIELD_HR_STATE) ? ~PACK_VALUE_MASK : 0) |
+                       ((staged & UI_FIELD_HR_VALUE) ? PACK_VALUE_MASK : 0);
+    uint32_t csc_mask = ((staged & UI_FIELD_CSC_STATE) ? ~PACK_VALUE_MASK : 0) |
+                        ((staged & UI_FIELD_CSC_CADENCE) ? PACK_VALUE_MASK : 0);
+    uint32_t fan_mask = 0;
+    for (uint32_t i = 0; i < UI_STATE_MAX_FANS; i++) {
+        if (staged & UI_FIELD_FAN(i)) fan_mask |= (FAN_STATE_MASK | FAN_ON_BIT) << (i * FAN_BITS);
+    }
+    word_update(&hr_word, hr_mask, batch->hr_word);
+    word_update(&csc_word, csc_mask, batch->csc_word);
+    word_update(&fan_word, fan_mask, batch->fan_word);
+    if (staged & UI_FIELD_FAN_COUNT) {
+        atomic_store_explicit(&fan_count_word, batch->fan_count, memory_order_release);
+    }
+    if (staged & UI_FIELD_HR_NAME) {
+        str_field_write(&hr_name_field.seq, hr_name_field.buf, sizeof(hr_name_field.buf), batch->hr_name);
+    }
+    if (staged & UI_FIELD_CSC_NAME) {
+        str_field_write(&csc_name_field.seq, csc_name_field.buf, sizeof(csc_name_field.buf), batch->csc_name);
+    }
+    if (staged & UI_FIELD_QR_URL) {
+        str_field_write(&qr_url_field.seq, qr_url_field.buf, sizeof(qr_url_field.buf), batch->qr_url);
+    }
+    uint32_t anim = batch->fan_anim & (staged >> UI_FIELD_FAN_SHIFT);
+    if (anim) atomic_fetch_or_explicit(&fan_anim_mask, anim, memory_order_relaxed);
+
+    batch->staged = 0;
+    batch->fan_anim = 0;
+    atomic_store_explicit(&batch->owner, NULL, memory_order_release);
+    return publish_now(staged);
+}
+
+/* ============================================================================
+ * Reader side (LVGL task)
+ * ============================================================================ */
+
+uint32_t ui_state_take_dirty(void)
+{
+    /* Open batches keep their bits and values in their slot, so this is never half a batch */
+    return atomic_exchange_explicit(&dirty_mask, 0, memory_order_acquire);
+}
+
+uint32_t ui_state_take_fan_anim(uint32_t fans)
+{
+    return atomic_fetch_and_explicit(&fan_anim_mask, ~fans, memory_order_relaxed) & fans;
+}
+
+hr_state_t ui_state_get_hr_state(void)
+{
+    return (hr_state_t)(atomic_load_explicit(&hr_word, memory_order_acquire) >> PACK_STATE_SHIFT);
+}
+
+uint16_t ui_state_get_hr_value(void)
+{
+    return (uint16_t)(atomic_load_explicit(&hr_word, memory_order_acquire) & PACK_VALUE_MASK);
+}
+
+csc_state_t ui_state_get_csc_state(void)
+{
+    return (csc_state_t)(atomic_load_explicit(&csc_word, memory_order_acquire) >> PACK_STATE_SHIFT);
+}
+
+uint16_t ui_state_get_csc_cadence(void)
+{
+    return (uint16_t)(atomic_load_explicit(&csc_word, memory_order_acquire) & PACK_VALUE_MASK);
+}
+
+fan_state_t ui_state_get_fan_state(uint8_t index)
+{
+    if (index >= UI_STATE_MAX_FANS) return FAN_STATE_NOT_CONFIGURATED;
+    uint32_t w = atomic_load_explicit(&fan_word, memory_order_acquire);
+    return (fan_state_t)((w >> (index * FAN_BITS)) & FAN_STATE_MASK);
+}
+
+bool ui_state_get_fan_on(uint8_t index)
+{
+    if (index >= UI_STATE_MAX_FANS) return false;
+    uint32_t w = atomic_load_explicit(&fan_word, memory_order_acquire);
+    return ((w >> (index * FAN_BITS)) & FAN_ON_BIT) != 0;
+}
+
+uint8_t ui_state_get_fan_count(void)
+{
+    return (uint8_t)atomic_load_explicit(&fan_count_word, memory_order_acquire);
+}
+
+bool ui_state_copy_hr_name(char *out, size_t len)
+{
+    return str_field_read(&hr_name_field.seq, hr_name_field.buf, out, len);
+}
+
+bool ui_state_copy_csc_name(char *out, size_t len)
+{
+    return str_field_read(&csc_name_field.seq, csc_name_field.buf, out, len);
+}
+
+bool ui_state_copy_qr_url(char *out, size_t len)
+{
+    return str_field_read(&qr_url_field.seq, qr_url_field.buf, out, len);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "homewind_ui.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * UI State Mailbox
+ * ============================================================================
+ * Written by the homewind_set_* setters from any task (loop(), BLE callbacks),
+ * drained by the LVGL task once per frame. No mutex: scalar fields are packed
+ * into atomic words, strings use a per-field sequence counter (one writer task
+ * per string field), and a shared dirty mask tells the LVGL task what to apply.
+ * Repeated writes between two frames simply overwrite each other.
+ * ============================================================================ */
+
+#define UI_STATE_MAX_FANS        HOMEWIND_MAX_FANS  /* 4 bits per fan in one 32-bit word */
+#define UI_STATE_BATCH_SLOTS     4                  /* Tasks that can hold a batch open at once */
+#define UI_STATE_NAME_LEN        32
+#define UI_STATE_URL_LEN         128
+
+/* --- Dirty bits (one per field) --- */
+#define UI_FIELD_HR_STATE        (1u << 0)
+#define UI_FIELD_HR_VALUE        (1u << 1)
+#define UI_FIELD_HR_NAME         (1u << 2)
+#define UI_FIELD_CSC_STATE       (1u << 3)
+#define UI_FIELD_CSC_CADENCE     (1u << 4)
+#define UI_FIELD_CSC_NAME        (1u << 5)
+#define UI_FIELD_QR_URL          (1u << 6)
+#define UI_FIELD_FAN_COUNT       (1u << 7)
+#define UI_FIELD_FAN_SHIFT       8
+#define UI_FIELD_FAN(i)          (1u << (UI_FIELD_FAN_SHIFT + (i)))
+#define UI_FIELD_FANS_ALL        (((1u << UI_STATE_MAX_FANS) - 1u) << UI_FIELD_FAN_SHIFT)
+
+#define UI_FIELDS_HR             (UI_FIELD_HR_STATE | UI_FIELD_HR_VALUE | UI_FIELD_HR_NAME)
+#define UI_FIELDS_CSC            (UI_FIELD_CSC_STATE | UI_FIELD_CSC_CADENCE | UI_FIELD_CSC_NAME)
+
+/* --- Writer side (any task) ---
+ * Each setter returns the dirty bits it raised (0 = value unchanged). task is the
+ * calling task: with a batch open the value goes into that batch, not the mailbox. */
+uint32_t ui_state_set_hr_state(hr_state_t state, const void *task);
+uint32_t ui_state_set_hr_value(uint16_t value, const void *task);
+uint32_t ui_state_set_hr_name(const char *name, const void *task);
+uint32_t ui_state_set_csc_state(csc_state_t state, const void *task);
+uint32_t ui_state_set_csc_cadence(uint16_t cadence, const void *task);
+uint32_t ui_state_set_csc_name(const char *name, const void *task);
+uint32_t ui_state_set_fan(uint8_t index, fan_state_t state, bool is_on, const void *task);
+uint32_t ui_state_set_fan_state(uint8_t index, fan_state_t state, const void *task);
+uint32_t ui_state_set_fan_on(uint8_t index, bool is_on, bool animate, const void *task);
+uint32_t ui_state_set_qr_url(const char *url, const void *task);
+uint32_t ui_state_set_fan_count(uint8_t count, const void *task);
+
+/**
+ * @brief Publish dirty bits to the LVGL task
+ * @param task Calling task; staged instead if it has a batch open
+ * @return true if the mailbox was clean before (caller should wake the LVGL task)
+ */
+bool ui_state_publish(uint32_t fields, const void *task);
+
+/* --- Batches (homewind_begin_update / homewind_commit_update) ---
+ * A batch belongs to the task that opened it: that task's values and bits are
+ * staged in the batch and its outermost commit publishes them at once. Other tasks publish
+ * as usual. Batches nest; up to UI_STATE_BATCH_SLOTS tasks at a time. */
+void ui_state_begin(const void *task);
+/** @return true if the outermost batch closed and the mailbox was clean before (wake the LVGL task) */
+bool ui_state_commit(const void *task);
+
+/* --- Reader side (LVGL task only) --- */
+uint32_t ui_state_take_dirty(void);
+/** @return Animate flags (bit i = fan i) of the given fans, cleared; other fans keep theirs */
+uint32_t ui_state_take_fan_anim(uint32_t fans);
+hr_state_t ui_state_get_hr_state(void);
+uint16_t ui_state_get_hr_value(void);
+csc_state_t ui_state_get_csc_state(void);
+uint16_t ui_state_get_csc_cadence(void);
+fan_state_t ui_state_get_fan_state(uint8_t index);
+bool ui_state_get_fan_on(uint8_t index);
+uint8_t ui_state_get_fan_count(void);
+/* String copies fail (return false) while the writer is mid-update; re-publish the bit and retry next frame */
+bool ui_state_copy_hr_name(char *out, size_t len);
+bool ui_state_copy_csc_name(char *out, size_t len);
+bool ui_state_copy_qr_url(char *out, size_t len);
+
+#ifdef __cplusplus
+}
+#endif